@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2025 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+
+# Minimal MQTT 3.1.1 broker used as a local stand-in for Mosquitto when benchmarking.
+# Supports CONNECT, SUBSCRIBE with + and # wildcards, PUBLISH with QoS 0 and 1, PINGREQ and
+# DISCONNECT. Sessions are not persisted and retained messages are not stored.
+
+import asyncio
+import struct
+import sys
+
+PORT = 1883
+
+CONNECT = 1
+CONNACK = 2
+PUBLISH = 3
+PUBACK = 4
+SUBSCRIBE = 8
+SUBACK = 9
+UNSUBSCRIBE = 10
+UNSUBACK = 11
+PINGREQ = 12
+PINGRESP = 13
+DISCONNECT = 14
+
+clients = set()
+
+
+def topic_matches(topic_filter, topic):
+    filter_levels = topic_filter.split("/")
+    topic_levels = topic.split("/")
+
+    for i, level in enumerate(filter_levels):
+        if level == "#":
+            return True
+        if i >= len(topic_levels):
+            return False
+        if level != "+" and level != topic_levels[i]:
+            return False
+
+    return len(filter_levels) == len(topic_levels)
+
+
+def encode_length(length):
+    encoded = bytearray()
+    while True:
+        byte = length % 128
+        length //= 128
+        if length > 0:
+            byte |= 0x80
+        encoded.append(byte)
+        if length == 0:
+            return bytes(encoded)
+
+
+def packet(packet_type, flags, body):
+    return bytes([(packet_type << 4) | flags]) + encode_length(len(body)) + body
+
+
+def utf8(data, offset):
+    (length,) = struct.unpack_from("!H", data, offset)
+    return data[offset + 2:offset + 2 + length].decode(), offset + 2 + length
+
+
+class Client:
+    def __init__(self, reader, writer):
+        self.reader = reader
+        self.writer = writer
+        self.client_id = None
+        self.subscriptions = {}
+        self.next_id = 1
+
+    async def read_packet(self):
+        header = await self.reader.readexactly(1)
+        length = 0
+        multiplier = 1
+        while True:
+            byte = (await self.reader.readexactly(1))[0]
+            length += (byte & 0x7F) * multiplier
+            multiplier *= 128
+            if not byte & 0x80:
+                break
+        body = await self.reader.readexactly(length)
+        return header[0] >> 4, header[0] & 0x0F, body
+
+    def send(self, data):
+        self.writer.write(data)
+
+    def deliver(self, topic, payload, qos):
+        body = struct.pack("!H", len(topic)) + topic.encode()
+        if qos > 0:
+            body += struct.pack("!H", self.next_id)
+            self.next_id = self.next_id % 0xFFFF + 1
+        self.send(packet(PUBLISH, qos << 1, body + payload))
+
+    def handle_connect(self, body):
+        _, offset = utf8(body, 0)
+        offset += 4  # Protocol level, connect flags and keep alive
+        self.client_id, _ = utf8(body, offset)
+        print(f"Client connected: {self.client_id}")
+        self.send(packet(CONNACK, 0, bytes([0, 0])))
+
+    def handle_subscribe(self, body):
+        (message_id,) = struct.unpack_from("!H", body, 0)
+        offset = 2
+        granted = bytearray()
+        while offset < len(body):
+            topic_filter, offset = utf8(body, offset)
+            qos = min(body[offset], 1)
+            offset += 1
+            self.subscriptions[topic_filter] = qos
+            granted.append(qos)
+            print(f"{self.client_id} subscribed to {topic_filter} with QoS {qos}")
+        self.send(packet(SUBACK, 0, struct.pack("!H", message_id) + bytes(granted)))
+
+    def handle_unsubscribe(self, body):
+        (message_id,) = struct.unpack_from("!H", body, 0)
+        offset = 2
+        while offset < len(body):
+            topic_filter, offset = utf8(body, offset)
+            self.subscriptions.pop(topic_filter, None)
+        self.send(packet(UNSUBACK, 0, struct.pack("!H", message_id)))
+
+    def handle_publish(self, flags, body):
+        qos = (flags >> 1) & 0x03
+        topic, offset = utf8(body, 0)
+        if qos > 0:
+            (message_id,) = struct.unpack_from("!H", body, offset)
+            offset += 2
+            self.send(packet(PUBACK, 0, struct.pack("!H", message_id)))
+        payload = body[offset:]
+
+        for client in clients:
+            granted = [q for f, q in client.subscriptions.items() if topic_matches(f, topic)]
+            if granted:
+                client.deliver(topic, payload, min(qos, max(granted)))
+
+    async def run(self):
+        try:
+            while True:
+                packet_type, flags, body = await self.read_packet()
+                if packet_type == CONNECT:
+                    self.handle_connect(body)
+                elif packet_type == SUBSCRIBE:
+                    self.handle_subscribe(body)
+                elif packet_type == UNSUBSCRIBE:
+                    self.handle_unsubscribe(body)
+                elif packet_type == PUBLISH:
+                    self.handle_publish(flags, body)
+                elif packet_type == PINGREQ:
+                    self.send(packet(PINGRESP, 0, b""))
+                elif packet_type == DISCONNECT:
+                    break
+                await self.writer.drain()
+        except (asyncio.IncompleteReadError, ConnectionResetError):
+            pass
+        finally:
+            print(f"Client disconnected: {self.client_id}")
+            self.writer.close()
+
+
+async def handle_client(reader, writer):
+    client = Client(reader, writer)
+    clients.add(client)
+    try:
+        await client.run()
+    finally:
+        clients.discard(client)
+
+
+async def main():
+    server = await asyncio.start_server(handle_client, "0.0.0.0", PORT)
+    print(f"Starting MQTT broker on port {PORT}")
+    async with server:
+        await server.serve_forever()
+
+
+if __name__ == "__main__":
+    try:
+        asyncio.run(main())
+    except KeyboardInterrupt:
+        print("\nKeyboard interrupt, exiting..")
+        sys.exit(130)
@@ -0,0 +1,259 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2025 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+
+# Minimal MQTT-SN 1.2 gateway used as a local stand-in when comparing MQTT-SN with MQTT.
+# The gateway is its own broker: it supports SEARCHGW, CONNECT, REGISTER, SUBSCRIBE by topic
+# name, predefined topic ID or short topic name, PUBLISH with QoS -1, 0 and 1, PINGREQ and
+# DISCONNECT with a sleep duration. Messages for sleeping clients are buffered and delivered
+# on the next PINGREQ. Lines typed as "<topic> <payload>" are published to subscribers.
+
+import asyncio
+import struct
+import sys
+
+PORT = 1885
+GATEWAY_ID = 1
+
+# Topic IDs known to both sides without REGISTER, needed for QoS -1
+PREDEFINED_TOPICS = {
+    1: "wifi/fund/board/publish/button/topic99",
+}
+
+SEARCHGW = 0x01
+GWINFO = 0x02
+CONNECT = 0x04
+CONNACK = 0x05
+REGISTER = 0x0A
+REGACK = 0x0B
+PUBLISH = 0x0C
+PUBACK = 0x0D
+SUBSCRIBE = 0x12
+SUBACK = 0x13
+UNSUBSCRIBE = 0x14
+UNSUBACK = 0x15
+PINGREQ = 0x16
+PINGRESP = 0x17
+DISCONNECT = 0x18
+
+TOPIC_NORMAL = 0
+TOPIC_PREDEFINED = 1
+TOPIC_SHORT = 2
+
+ACCEPTED = 0
+REJECTED_INVALID_TOPIC = 2
+
+QOS_M1 = 3
+
+
+def message(msg_type, body):
+    length = len(body) + 2
+    if length < 256:
+        return bytes([length, msg_type]) + body
+    return struct.pack("!BHB", 1, length + 2, msg_type) + body
+
+
+def parse(data):
+    if data[0] == 1:
+        (length,) = struct.unpack_from("!H", data, 1)
+        return data[3], data[4:length]
+    return data[1], data[2:data[0]]
+
+
+class Client:
+    def __init__(self, addr):
+        self.addr = addr
+        self.client_id = None
+        self.topics = {}
+        self.subscriptions = {}
+        self.asleep = False
+        self.buffered = []
+        self.next_id = 1
+
+    def msg_id(self):
+        msg_id = self.next_id
+        self.next_id = self.next_id % 0xFFFF + 1
+        return msg_id
+
+
+class Gateway(asyncio.DatagramProtocol):
+    def __init__(self):
+        self.transport = None
+        self.clients = {}
+        self.topic_ids = {name: topic_id for topic_id, name in PREDEFINED_TOPICS.items()}
+        self.next_topic_id = max(PREDEFINED_TOPICS, default=0) + 1
+        self.rx_bytes = 0
+        self.rx_publishes = 0
+
+    def connection_made(self, transport):
+        self.transport = transport
+
+    def send(self, client, msg_type, body):
+        self.transport.sendto(message(msg_type, body), client.addr)
+
+    def topic_id(self, name):
+        if name not in self.topic_ids:
+            self.topic_ids[name] = self.next_topic_id
+            self.next_topic_id += 1
+        return self.topic_ids[name]
+
+    def topic_name(self, topic_type, raw):
+        if topic_type == TOPIC_SHORT:
+            return raw.decode()
+        (topic_id,) = struct.unpack("!H", raw)
+        if topic_type == TOPIC_PREDEFINED:
+            return PREDEFINED_TOPICS.get(topic_id)
+        return next((n for n, i in self.topic_ids.items() if i == topic_id), None)
+
+    def deliver(self, client, topic, payload):
+        if client.asleep:
+            client.buffered.append((topic, payload))
+            return
+
+        if len(topic) == 2:
+            topic_type, raw = TOPIC_SHORT, topic.encode()
+        else:
+            topic_id = self.topic_id(topic)
+            topic_type, raw = TOPIC_NORMAL, struct.pack("!H", topic_id)
+            if topic not in client.topics:
+                client.topics[topic] = topic_id
+                self.send(client, REGISTER, struct.pack("!HH", topic_id, client.msg_id()) +
+                          topic.encode())
+
+        flags = (client.subscriptions[topic] << 5) | topic_type
+        self.send(client, PUBLISH, bytes([flags]) + raw +
+                  struct.pack("!H", client.msg_id()) + payload)
+
+    def route(self, topic, payload):
+        for client in self.clients.values():
+            if topic in client.subscriptions:
+                self.deliver(client, topic, payload)
+
+    def handle_connect(self, client, body):
+        client.client_id = body[4:].decode()
+        client.asleep = False
+        print(f"Client connected: {client.client_id}")
+        self.send(client, CONNACK, bytes([ACCEPTED]))
+
+    def handle_register(self, client, body):
+        (msg_id,) = struct.unpack_from("!H", body, 2)
+        name = body[4:].decode()
+        topic_id = self.topic_id(name)
+        client.topics[name] = topic_id
+        self.send(client, REGACK, struct.pack("!HHB", topic_id, msg_id, ACCEPTED))
+
+    def handle_subscribe(self, client, body):
+        flags = body[0]
+        (msg_id,) = struct.unpack_from("!H", body, 1)
+        qos = min((flags >> 5) & 0x03, 1)
+        topic_type = flags & 0x03
+        name = self.topic_name(topic_type, body[3:]) if topic_type != TOPIC_NORMAL \
+            else body[3:].decode()
+
+        if name is None:
+            self.send(client, SUBACK, struct.pack("!BHHB", 0, 0, msg_id, REJECTED_INVALID_TOPIC))
+            return
+
+        topic_id = 0 if topic_type == TOPIC_SHORT else self.topic_id(name)
+        client.subscriptions[name] = qos
+        client.topics[name] = topic_id
+        print(f"{client.client_id} subscribed to {name} with QoS {qos}")
+        self.send(client, SUBACK, struct.pack("!BHHB", qos << 5, topic_id, msg_id, ACCEPTED))
+
+    def handle_publish(self, client, body, size):
+        flags = body[0]
+        qos = (flags >> 5) & 0x03
+        raw = body[1:3]
+        (msg_id,) = struct.unpack_from("!H", body, 3)
+        payload = body[5:]
+        name = self.topic_name(flags & 0x03, raw)
+
+        self.rx_bytes += size
+        self.rx_publishes += 1
+        print(f"PUBLISH from {client.client_id or client.addr} QoS {-1 if qos == QOS_M1 else qos}"
+              f" on {name}: {size} bytes, average {self.rx_bytes // self.rx_publishes} bytes")
+
+        if qos == 1:
+            code = ACCEPTED if name else REJECTED_INVALID_TOPIC
+            self.send(client, PUBACK, raw + struct.pack("!HB", msg_id, code))
+        if name:
+            self.route(name, payload)
+
+    def handle_pingreq(self, client, body):
+        if body:
+            # A sleeping client checking for messages
+            for topic, payload in client.buffered:
+                client.asleep = False
+                self.deliver(client, topic, payload)
+                client.asleep = True
+            client.buffered.clear()
+        self.send(client, PINGRESP, b"")
+
+    def handle_disconnect(self, client, body):
+        if body:
+            (duration,) = struct.unpack("!H", body)
+            client.asleep = True
+            print(f"{client.client_id} asleep for {duration} s")
+        else:
+            print(f"Client disconnected: {client.client_id}")
+            self.clients.pop(client.addr, None)
+        self.send(client, DISCONNECT, b"")
+
+    def datagram_received(self, data, addr):
+        try:
+            msg_type, body = parse(data)
+        except (IndexError, struct.error):
+            return
+
+        if msg_type == SEARCHGW:
+            self.transport.sendto(message(GWINFO, bytes([GATEWAY_ID])), addr)
+            return
+
+        client = self.clients.setdefault(addr, Client(addr))
+        try:
+            if msg_type == CONNECT:
+                self.handle_connect(client, body)
+            elif msg_type == REGISTER:
+                self.handle_register(client, body)
+            elif msg_type == SUBSCRIBE:
+                self.handle_subscribe(client, body)
+            elif msg_type == PUBLISH:
+                self.handle_publish(client, body, len(data))
+            elif msg_type == PINGREQ:
+                self.handle_pingreq(client, body)
+            elif msg_type == DISCONNECT:
+                self.handle_disconnect(client, body)
+        except (IndexError, struct.error, UnicodeDecodeError):
+            print(f"Malformed message 0x{msg_type:02x} from {addr}")
+
+
+async def read_stdin(gateway):
+    loop = asyncio.get_running_loop()
+    while True:
+        line = await loop.run_in_executor(None, sys.stdin.readline)
+        if not line:
+            return
+        topic, _, payload = line.strip().partition(" ")
+        if topic:
+            gateway.route(topic, payload.encode())
+
+
+async def main():
+    loop = asyncio.get_running_loop()
+    transport, gateway = await loop.create_datagram_endpoint(Gateway, local_addr=("0.0.0.0", PORT))
+    print(f"Starting MQTT-SN gateway on UDP port {PORT}")
+    try:
+        await read_stdin(gateway)
+        await asyncio.Event().wait()
+    finally:
+        transport.close()
+
+
+if __name__ == "__main__":
+    try:
+        asyncio.run(main())
+    except KeyboardInterrupt:
+        print("\nKeyboard interrupt, exiting..")
+        sys.exit(130)
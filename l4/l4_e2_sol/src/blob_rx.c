@@ -0,0 +1,368 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/random/random.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/mqtt.h>
+#include <zephyr/sys/crc.h>
+
+#include "blob_rx.h"
+
+LOG_MODULE_REGISTER(blob_rx, LOG_LEVEL_INF);
+
+#define BLOB_TOPIC CONFIG_MQTT_SAMPLE_BLOB_TOPIC
+#define HOSTNAME_LEN 128
+#define SUBSCRIBE_ID 1
+
+struct blob_state {
+	bool active;
+	size_t total_len;
+	size_t received;
+	int64_t started;
+};
+
+struct crc_sink_ctx {
+	uint32_t crc;
+};
+
+static int crc_sink_begin(size_t total_len, void *ctx)
+{
+	struct crc_sink_ctx *crc_ctx = ctx;
+
+	crc_ctx->crc = 0;
+	LOG_INF("Receiving blob, %d bytes", total_len);
+	return 0;
+}
+
+static int crc_sink_write(size_t offset, const uint8_t *data, size_t len, void *ctx)
+{
+	struct crc_sink_ctx *crc_ctx = ctx;
+
+	crc_ctx->crc = crc32_ieee_update(crc_ctx->crc, data, len);
+	return 0;
+}
+
+static void crc_sink_end(int status, void *ctx)
+{
+	struct crc_sink_ctx *crc_ctx = ctx;
+
+	if (status == 0) {
+		LOG_INF("Blob CRC32: 0x%08x", crc_ctx->crc);
+	}
+}
+
+static struct crc_sink_ctx crc_ctx;
+static const struct blob_rx_sink crc_sink = {
+	.begin = crc_sink_begin,
+	.write = crc_sink_write,
+	.end = crc_sink_end,
+	.ctx = &crc_ctx,
+};
+
+static const struct blob_rx_sink *sink = &crc_sink;
+static struct blob_state blob;
+
+static struct mqtt_client client;
+static struct sockaddr_storage broker;
+static uint8_t rx_buf[CONFIG_MQTT_SAMPLE_BLOB_BUFFER_SIZE];
+static uint8_t tx_buf[CONFIG_MQTT_SAMPLE_BLOB_BUFFER_SIZE];
+static uint8_t chunk[CONFIG_MQTT_SAMPLE_BLOB_BUFFER_SIZE];
+static char client_id[sizeof(CONFIG_BOARD) + 16];
+static char hostname[HOSTNAME_LEN];
+static bool started;
+
+static K_MUTEX_DEFINE(hostname_lock);
+
+#if defined(CONFIG_MQTT_LIB_TLS)
+static sec_tag_t sec_tag_list[] = { CONFIG_MQTT_HELPER_SEC_TAG };
+#endif
+
+void blob_rx_sink_register(const struct blob_rx_sink *new_sink)
+{
+	__ASSERT_NO_MSG(!blob.active);
+
+	sink = new_sink ? new_sink : &crc_sink;
+}
+
+/* Streams the payload of a PUBLISH from the socket to the sink. The whole payload must be read
+ * before the next call to mqtt_input(), even when the sink gives up on it.
+ */
+static int payload_stream(const struct mqtt_publish_param *pub)
+{
+	int ret;
+	int err;
+	size_t len;
+
+	blob.total_len = pub->message.payload.len;
+	blob.received = 0;
+	blob.started = k_uptime_get();
+	blob.active = true;
+
+	err = sink->begin(blob.total_len, sink->ctx);
+	if (err) {
+		LOG_WRN("Sink rejected blob of %d bytes, err: %d", blob.total_len, err);
+	}
+
+	while (blob.received < blob.total_len) {
+		len = MIN(sizeof(chunk), blob.total_len - blob.received);
+
+		ret = mqtt_read_publish_payload_blocking(&client, chunk, len);
+		if (ret <= 0) {
+			/* The stream is out of sync, only a new connection recovers from this. */
+			err = ret ? ret : -EIO;
+			break;
+		}
+
+		if (!err) {
+			err = sink->write(blob.received, chunk, ret, sink->ctx);
+		}
+
+		blob.received += ret;
+	}
+
+	blob.active = false;
+	sink->end(err, sink->ctx);
+
+	if (err) {
+		LOG_WRN("Blob aborted after %d of %d bytes, err: %d", blob.received,
+			blob.total_len, err);
+	} else {
+		LOG_INF("Blob complete, %d bytes in %lld ms", blob.total_len,
+			k_uptime_get() - blob.started);
+	}
+
+	return blob.received == blob.total_len ? 0 : err;
+}
+
+static void subscribe(void)
+{
+	int err;
+	struct mqtt_topic topic = {
+		.topic = {
+			.utf8 = BLOB_TOPIC,
+			.size = sizeof(BLOB_TOPIC) - 1
+		},
+		.qos = MQTT_QOS_1_AT_LEAST_ONCE
+	};
+	struct mqtt_subscription_list subscription_list = {
+		.list = &topic,
+		.list_count = 1,
+		.message_id = SUBSCRIBE_ID
+	};
+
+	err = mqtt_subscribe(&client, &subscription_list);
+	if (err) {
+		LOG_ERR("Failed to subscribe to %s, err: %d", BLOB_TOPIC, err);
+		return;
+	}
+
+	LOG_INF("Subscribing to %s", BLOB_TOPIC);
+}
+
+static void mqtt_evt_handler(struct mqtt_client *c, const struct mqtt_evt *evt)
+{
+	int err;
+
+	switch (evt->type) {
+	case MQTT_EVT_CONNACK:
+		if (evt->result != 0) {
+			LOG_ERR("Blob connection rejected, result: %d", evt->result);
+			break;
+		}
+
+		subscribe();
+		break;
+	case MQTT_EVT_DISCONNECT:
+		LOG_INF("Blob connection closed, result: %d", evt->result);
+		break;
+	case MQTT_EVT_PUBLISH: {
+		const struct mqtt_publish_param *pub = &evt->param.publish;
+
+		/* A failed read already closed the connection, blob_run() then reconnects. */
+		err = payload_stream(pub);
+		if (err) {
+			break;
+		}
+
+		if (pub->message.topic.qos == MQTT_QOS_1_AT_LEAST_ONCE) {
+			struct mqtt_puback_param ack = {
+				.message_id = pub->message_id
+			};
+
+			(void)mqtt_publish_qos1_ack(c, &ack);
+		}
+		break;
+	}
+	case MQTT_EVT_SUBACK:
+		LOG_INF("Subscribed to %s", BLOB_TOPIC);
+		break;
+	default:
+		break;
+	}
+}
+
+static int broker_resolve(const char *host)
+{
+	int err;
+	char port[6];
+	struct zsock_addrinfo *result;
+	struct zsock_addrinfo hints = {
+		.ai_family = AF_INET,
+		.ai_socktype = SOCK_STREAM
+	};
+
+	snprintf(port, sizeof(port), "%d", CONFIG_MQTT_HELPER_PORT);
+
+	err = zsock_getaddrinfo(host, port, &hints, &result);
+	if (err) {
+		LOG_ERR("Failed to resolve %s, err: %d", host, err);
+		return -EHOSTUNREACH;
+	}
+
+	memcpy(&broker, result->ai_addr, result->ai_addrlen);
+	zsock_freeaddrinfo(result);
+
+	return 0;
+}
+
+static int blob_connect(void)
+{
+	int err;
+	/* Kept for the TLS hostname check */
+	static char host[HOSTNAME_LEN];
+
+	k_mutex_lock(&hostname_lock, K_FOREVER);
+	strcpy(host, hostname);
+	k_mutex_unlock(&hostname_lock);
+
+	err = broker_resolve(host);
+	if (err) {
+		return err;
+	}
+
+	mqtt_client_init(&client);
+
+	client.broker = &broker;
+	client.evt_cb = mqtt_evt_handler;
+	client.client_id.utf8 = (uint8_t *)client_id;
+	client.client_id.size = strlen(client_id);
+	client.protocol_version = MQTT_VERSION_3_1_1;
+	client.rx_buf = rx_buf;
+	client.rx_buf_size = sizeof(rx_buf);
+	client.tx_buf = tx_buf;
+	client.tx_buf_size = sizeof(tx_buf);
+
+#if defined(CONFIG_MQTT_LIB_TLS)
+	struct mqtt_sec_config *tls_config = &client.transport.tls.config;
+
+	client.transport.type = MQTT_TRANSPORT_SECURE;
+	tls_config->peer_verify = TLS_PEER_VERIFY_REQUIRED;
+	tls_config->sec_tag_list = sec_tag_list;
+	tls_config->sec_tag_count = ARRAY_SIZE(sec_tag_list);
+	tls_config->hostname = host;
+#else
+	client.transport.type = MQTT_TRANSPORT_NON_SECURE;
+#endif
+
+	err = mqtt_connect(&client);
+	if (err) {
+		LOG_ERR("Failed to connect to %s, err: %d", host, err);
+	}
+
+	return err;
+}
+
+static int socket_get(void)
+{
+#if defined(CONFIG_MQTT_LIB_TLS)
+	return client.transport.tls.sock;
+#else
+	return client.transport.tcp.sock;
+#endif
+}
+
+/* Runs the connection until it drops. */
+static int blob_run(void)
+{
+	int ret;
+	int err;
+	struct zsock_pollfd fds = {
+		.fd = socket_get(),
+		.events = ZSOCK_POLLIN
+	};
+
+	while (true) {
+		ret = zsock_poll(&fds, 1, mqtt_keepalive_time_left(&client));
+		if (ret < 0) {
+			err = -errno;
+			break;
+		}
+
+		err = mqtt_live(&client);
+		if (err && err != -EAGAIN) {
+			break;
+		}
+
+		if (fds.revents & ZSOCK_POLLIN) {
+			err = mqtt_input(&client);
+			if (err) {
+				break;
+			}
+		}
+
+		if (fds.revents & (ZSOCK_POLLERR | ZSOCK_POLLHUP | ZSOCK_POLLNVAL)) {
+			err = -ENOTCONN;
+			break;
+		}
+	}
+
+	(void)mqtt_abort(&client);
+	return err;
+}
+
+static void blob_rx_thread(void)
+{
+	int err;
+
+	snprintf(client_id, sizeof(client_id), "%s-blob-%08x", CONFIG_BOARD, sys_rand32_get());
+
+	while (true) {
+		err = blob_connect();
+		if (!err) {
+			err = blob_run();
+		}
+
+		LOG_WRN("Blob connection lost, err: %d, retrying in %d s", err,
+			CONFIG_MQTT_SAMPLE_BLOB_RETRY_S);
+		k_sleep(K_SECONDS(CONFIG_MQTT_SAMPLE_BLOB_RETRY_S));
+	}
+}
+
+K_THREAD_DEFINE(blob_rx_tid, CONFIG_MQTT_SAMPLE_BLOB_STACK_SIZE, blob_rx_thread, NULL, NULL, NULL,
+		K_LOWEST_APPLICATION_THREAD_PRIO, 0, K_TICKS_FOREVER);
+
+int blob_rx_start(const char *host)
+{
+	if (!host || strlen(host) >= sizeof(hostname)) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&hostname_lock, K_FOREVER);
+	strcpy(hostname, host);
+	k_mutex_unlock(&hostname_lock);
+
+	if (!started) {
+		started = true;
+		k_thread_start(blob_rx_tid);
+	}
+
+	return 0;
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef BLOB_RX_H_
+#define BLOB_RX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Consumer of received blobs.
+ *
+ * The payload of every PUBLISH on CONFIG_MQTT_SAMPLE_BLOB_TOPIC is passed to the sink in
+ * CONFIG_MQTT_SAMPLE_BLOB_BUFFER_SIZE chunks as it is read from the socket, so the message is
+ * never held in RAM as a whole. Returning a negative error code from begin() or write() aborts
+ * the blob, the rest of the payload is then read and discarded.
+ */
+struct blob_rx_sink {
+	int (*begin)(size_t total_len, void *ctx);
+	int (*write)(size_t offset, const uint8_t *data, size_t len, void *ctx);
+	/* Called with 0 when the blob is complete, or a negative error code if it was aborted. */
+	void (*end)(int status, void *ctx);
+	void *ctx;
+};
+
+/**
+ * @brief Register the sink that receives blobs. Replaces the default CRC32 logging sink.
+ *
+ * Must not be called while a blob is being received.
+ */
+void blob_rx_sink_register(const struct blob_rx_sink *sink);
+
+/**
+ * @brief Start receiving blobs.
+ *
+ * The MQTT helper reads every payload into its own buffer, so blobs are received on a second
+ * MQTT connection to the same broker that only subscribes to CONFIG_MQTT_SAMPLE_BLOB_TOPIC.
+ * The connection runs in its own thread and is reestablished when it drops. Calls after the
+ * first one only update the broker hostname used for the next connection.
+ *
+ * @param hostname Broker to connect to.
+ */
+int blob_rx_start(const char *hostname);
+
+#endif /* BLOB_RX_H_ */
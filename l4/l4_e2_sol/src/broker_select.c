@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/settings/settings.h>
+
+#include "broker_select.h"
+
+LOG_MODULE_REGISTER(broker_select, LOG_LEVEL_INF);
+
+#define SETTINGS_SUBTREE "mqtt_broker"
+#define SETTINGS_WINNER SETTINGS_SUBTREE "/winner"
+
+struct candidate {
+	char host[BROKER_SELECT_HOSTNAME_LEN];
+	/* UINT32_MAX when unreachable. */
+	uint32_t rtt_ms;
+};
+
+static struct candidate candidates[CONFIG_MQTT_SAMPLE_BROKER_LIST_MAX];
+static size_t candidate_count;
+static size_t current;
+static char stored_winner[BROKER_SELECT_HOSTNAME_LEN];
+static bool initialized;
+
+#if defined(CONFIG_MQTT_SAMPLE_BROKER_PERSIST)
+static int broker_settings_set(const char *name, size_t len, settings_read_cb read_cb,
+			       void *cb_arg)
+{
+	int ret;
+	const char *next;
+
+	if (!settings_name_steq(name, "winner", &next) || next) {
+		return -ENOENT;
+	}
+
+	if (len >= sizeof(stored_winner)) {
+		return -EINVAL;
+	}
+
+	ret = read_cb(cb_arg, stored_winner, len);
+	if (ret < 0) {
+		return ret;
+	}
+
+	stored_winner[len] = '\0';
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(mqtt_broker, SETTINGS_SUBTREE, NULL, broker_settings_set, NULL,
+			       NULL);
+#endif
+
+static int list_parse(void)
+{
+	const char *pos = CONFIG_MQTT_SAMPLE_BROKER_LIST;
+
+	candidate_count = 0;
+
+	while (*pos != '\0' && candidate_count < ARRAY_SIZE(candidates)) {
+		const char *end = strchr(pos, ',');
+		size_t len = end ? (size_t)(end - pos) : strlen(pos);
+
+		if (len > 0 && len < BROKER_SELECT_HOSTNAME_LEN) {
+			memcpy(candidates[candidate_count].host, pos, len);
+			candidates[candidate_count].host[len] = '\0';
+			candidates[candidate_count].rtt_ms = UINT32_MAX;
+			candidate_count++;
+		} else if (len > 0) {
+			LOG_WRN("Broker hostname too long: %.*s", len, pos);
+		}
+
+		if (!end) {
+			break;
+		}
+		pos = end + 1;
+	}
+
+	return candidate_count > 0 ? 0 : -EINVAL;
+}
+
+static int probe(const char *host, uint32_t *rtt_ms)
+{
+	int err;
+	int sock;
+	int so_error = 0;
+	socklen_t optlen = sizeof(so_error);
+	int64_t start;
+	char port[6];
+	struct zsock_addrinfo *result;
+	struct zsock_addrinfo hints = {
+		.ai_family = AF_INET,
+		.ai_socktype = SOCK_STREAM,
+	};
+	struct zsock_pollfd fds;
+
+	snprintf(port, sizeof(port), "%d", CONFIG_MQTT_HELPER_PORT);
+
+	err = zsock_getaddrinfo(host, port, &hints, &result);
+	if (err) {
+		LOG_WRN("Failed to resolve %s, err: %d, %s", host, err, zsock_gai_strerror(err));
+		return -EHOSTUNREACH;
+	}
+
+	sock = zsock_socket(result->ai_family, SOCK_STREAM, IPPROTO_TCP);
+	if (sock < 0) {
+		zsock_freeaddrinfo(result);
+		return -errno;
+	}
+
+	(void)zsock_fcntl(sock, F_SETFL, zsock_fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+
+	start = k_uptime_get();
+	err = zsock_connect(sock, result->ai_addr, result->ai_addrlen);
+	zsock_freeaddrinfo(result);
+
+	if (err < 0 && errno != EINPROGRESS) {
+		err = -errno;
+		goto out;
+	}
+
+	fds.fd = sock;
+	fds.events = ZSOCK_POLLOUT;
+
+	err = zsock_poll(&fds, 1, CONFIG_MQTT_SAMPLE_BROKER_PROBE_TIMEOUT_MS);
+	if (err == 0) {
+		err = -ETIMEDOUT;
+		goto out;
+	} else if (err < 0) {
+		err = -errno;
+		goto out;
+	}
+
+	(void)zsock_getsockopt(sock, SOL_SOCKET, SO_ERROR, &so_error, &optlen);
+	if (so_error) {
+		err = -so_error;
+		goto out;
+	}
+
+	*rtt_ms = (uint32_t)(k_uptime_get() - start);
+	err = 0;
+
+out:
+	zsock_close(sock);
+	return err;
+}
+
+static int rtt_compare(const void *a, const void *b)
+{
+	const struct candidate *ca = a;
+	const struct candidate *cb = b;
+
+	return (ca->rtt_ms > cb->rtt_ms) - (ca->rtt_ms < cb->rtt_ms);
+}
+
+static int probe_all(const char *failed)
+{
+	int err;
+
+	for (size_t i = 0; i < candidate_count; i++) {
+		candidates[i].rtt_ms = UINT32_MAX;
+
+		err = probe(candidates[i].host, &candidates[i].rtt_ms);
+		if (err) {
+			LOG_INF("%s: unreachable, err: %d", candidates[i].host, err);
+			continue;
+		}
+
+		LOG_INF("%s: %d ms", candidates[i].host, candidates[i].rtt_ms);
+	}
+
+	qsort(candidates, candidate_count, sizeof(candidates[0]), rtt_compare);
+	current = 0;
+
+	if (candidates[0].rtt_ms == UINT32_MAX) {
+		LOG_ERR("No broker in the list is reachable");
+		return -ENETUNREACH;
+	}
+
+	/* A broker that accepts TCP but just failed is only retried when nothing else answers. */
+	if (failed && strcmp(candidates[0].host, failed) == 0 && candidate_count > 1 &&
+	    candidates[1].rtt_ms != UINT32_MAX) {
+		current = 1;
+	}
+
+	return 0;
+}
+
+static int host_copy(char *host, size_t len)
+{
+	if (strlen(candidates[current].host) >= len) {
+		return -ENOMEM;
+	}
+
+	strcpy(host, candidates[current].host);
+	return 0;
+}
+
+static int init(void)
+{
+	int err;
+
+	err = list_parse();
+	if (err) {
+		LOG_ERR("CONFIG_MQTT_SAMPLE_BROKER_LIST is empty");
+		return err;
+	}
+
+	if (IS_ENABLED(CONFIG_MQTT_SAMPLE_BROKER_PERSIST)) {
+		err = settings_subsys_init();
+		if (!err) {
+			err = settings_load_subtree(SETTINGS_SUBTREE);
+		}
+		if (err) {
+			LOG_WRN("Failed to load stored broker, err: %d", err);
+		}
+	}
+
+	initialized = true;
+	return 0;
+}
+
+int broker_select_first(char *host, size_t len)
+{
+	int err;
+
+	if (!initialized) {
+		err = init();
+		if (err) {
+			return err;
+		}
+	}
+
+	for (size_t i = 0; i < candidate_count; i++) {
+		if (strcmp(candidates[i].host, stored_winner) == 0) {
+			LOG_INF("Using stored broker %s", stored_winner);
+			current = i;
+			return host_copy(host, len);
+		}
+	}
+
+	LOG_INF("Probing %d brokers", candidate_count);
+
+	err = probe_all(NULL);
+	if (err) {
+		return err;
+	}
+
+	return host_copy(host, len);
+}
+
+int broker_select_next(char *host, size_t len)
+{
+	int err;
+	char failed[BROKER_SELECT_HOSTNAME_LEN];
+
+	if (!initialized) {
+		return broker_select_first(host, len);
+	}
+
+	strcpy(failed, candidates[current].host);
+	current++;
+
+	if (current >= candidate_count || candidates[current].rtt_ms == UINT32_MAX) {
+		LOG_INF("No untried broker left, probing again");
+
+		err = probe_all(failed);
+		if (err) {
+			return err;
+		}
+	}
+
+	LOG_INF("Failing over to %s", candidates[current].host);
+	return host_copy(host, len);
+}
+
+void broker_select_confirm(void)
+{
+	int err;
+
+	if (!IS_ENABLED(CONFIG_MQTT_SAMPLE_BROKER_PERSIST) ||
+	    strcmp(stored_winner, candidates[current].host) == 0) {
+		return;
+	}
+
+	strcpy(stored_winner, candidates[current].host);
+
+	err = settings_save_one(SETTINGS_WINNER, stored_winner, strlen(stored_winner));
+	if (err) {
+		LOG_WRN("Failed to store broker, err: %d", err);
+		return;
+	}
+
+	LOG_INF("Stored %s as preferred broker", stored_winner);
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef BROKER_SELECT_H_
+#define BROKER_SELECT_H_
+
+#include <stddef.h>
+
+#define BROKER_SELECT_HOSTNAME_LEN 64
+
+/**
+ * @brief Get the broker to connect to first.
+ *
+ * The broker that last accepted a connection is returned without probing if it was stored and
+ * is still in CONFIG_MQTT_SAMPLE_BROKER_LIST. Otherwise every broker in the list is probed
+ * with a TCP connect and the one with the lowest round-trip time is returned.
+ *
+ * @retval 0 on success.
+ * @retval -ENETUNREACH if no broker in the list could be reached.
+ */
+int broker_select_first(char *host, size_t len);
+
+/**
+ * @brief Get the next broker after a failed connection.
+ *
+ * Candidates are tried in order of probed round-trip time. The list is probed again once every
+ * reachable broker has failed.
+ *
+ * @retval 0 on success.
+ * @retval -ENETUNREACH if no broker in the list could be reached.
+ */
+int broker_select_next(char *host, size_t len);
+
+/** @brief Mark the current broker as working and store it for the next boot. */
+void broker_select_confirm(void);
+
+#endif /* BROKER_SELECT_H_ */
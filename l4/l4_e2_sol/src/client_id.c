@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/random/random.h>
+#include <zephyr/settings/settings.h>
+
+#include "client_id.h"
+
+LOG_MODULE_REGISTER(client_id, LOG_LEVEL_INF);
+
+#define SETTINGS_SUBTREE "mqtt_sample"
+#define SETTINGS_CLIENT_ID SETTINGS_SUBTREE "/client_id"
+
+static char stored_id[sizeof(CONFIG_BOARD) + 11];
+static bool loaded;
+
+static int client_id_settings_set(const char *name, size_t len, settings_read_cb read_cb,
+				  void *cb_arg)
+{
+	int ret;
+	const char *next;
+
+	if (!settings_name_steq(name, "client_id", &next) || next) {
+		return -ENOENT;
+	}
+
+	if (len >= sizeof(stored_id)) {
+		return -EINVAL;
+	}
+
+	ret = read_cb(cb_arg, stored_id, len);
+	if (ret < 0) {
+		return ret;
+	}
+
+	stored_id[len] = '\0';
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(mqtt_sample, SETTINGS_SUBTREE, NULL, client_id_settings_set, NULL,
+			       NULL);
+
+static int client_id_load(void)
+{
+	int err;
+
+	err = settings_subsys_init();
+	if (err) {
+		LOG_ERR("Failed to initialize settings, err: %d", err);
+		return err;
+	}
+
+	err = settings_load_subtree(SETTINGS_SUBTREE);
+	if (err) {
+		LOG_ERR("Failed to load settings, err: %d", err);
+		return err;
+	}
+
+	if (stored_id[0] != '\0') {
+		LOG_INF("Using stored client ID");
+		return 0;
+	}
+
+	snprintf(stored_id, sizeof(stored_id), "%s-%010u", CONFIG_BOARD, sys_rand32_get());
+
+	err = settings_save_one(SETTINGS_CLIENT_ID, stored_id, strlen(stored_id));
+	if (err) {
+		LOG_ERR("Failed to store client ID, err: %d", err);
+		return err;
+	}
+
+	LOG_INF("Generated and stored new client ID");
+	return 0;
+}
+
+int client_id_get(char *buf, size_t len)
+{
+	int err;
+
+	if (!loaded) {
+		err = client_id_load();
+		if (err) {
+			return err;
+		}
+		loaded = true;
+	}
+
+	if (strlen(stored_id) >= len) {
+		return -ENOMEM;
+	}
+
+	strcpy(buf, stored_id);
+	return 0;
+}
@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef CLIENT_ID_H_
+#define CLIENT_ID_H_
+
+#include <stddef.h>
+
+/**
+ * @brief Get the MQTT client ID stored in the settings subsystem.
+ *
+ * The first call on a fresh device generates a "<board>-<random>" ID and stores it, so the
+ * broker sees the same client ID on every boot and can keep a persistent session for it.
+ *
+ * @param buf Buffer for the NULL-terminated client ID.
+ * @param len Size of @p buf.
+ *
+ * @retval 0 on success.
+ * @retval -ENOMEM if @p buf is too small.
+ * @retval Other negative error codes from the settings subsystem.
+ */
+int client_id_get(char *buf, size_t len);
+
+#endif /* CLIENT_ID_H_ */
@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/random/random.h>
+
+#include "coalesce.h"
+#include "mqtt_work.h"
+#include "telemetry_cbor.h"
+
+LOG_MODULE_REGISTER(coalesce, LOG_LEVEL_INF);
+
+BUILD_ASSERT(CONFIG_MQTT_SAMPLE_COALESCE_MAX_SAMPLES <= TELEMETRY_MAX_SAMPLES,
+	     "A batch must fit in one telemetry message");
+
+/* Per-message overhead below the payload: MQTT fixed header, topic and message ID, TCP and IPv4
+ * headers and, with TLS, the record header and AES-GCM nonce and tag.
+ */
+#define MQTT_OVERHEAD (2 + 2 + sizeof(CONFIG_MQTT_SAMPLE_PUB_TOPIC) - 1 + 2)
+#define TCP_IP_OVERHEAD 40
+#define TLS_OVERHEAD (IS_ENABLED(CONFIG_MQTT_LIB_TLS) ? 5 + 8 + 16 : 0)
+#define WIRE_OVERHEAD (MQTT_OVERHEAD + TCP_IP_OVERHEAD + TLS_OVERHEAD)
+
+enum flush_reason {
+	FLUSH_DEADLINE,
+	FLUSH_COUNT,
+	FLUSH_SIZE,
+	FLUSH_EVENT,
+};
+
+struct batch {
+	struct telemetry_msg msg;
+	/* Encoded size of the samples alone. */
+	size_t samples_size;
+	int64_t first_sample;
+	enum flush_reason reason;
+	bool flushing;
+};
+
+/* The batch being filled and the one handed to flush_work, which runs on the MQTT work queue
+ * because it publishes. Samples that arrive while a batch is published go into the next one.
+ */
+static struct batch batch;
+static struct batch pending;
+static struct coalesce_stats stats;
+static struct k_spinlock lock;
+static coalesce_publish_t publish_fn;
+static uint32_t seq;
+
+static void flush_work_fn(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(flush_work, flush_work_fn);
+
+static void report_work_fn(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(report_work, report_work_fn);
+
+static void sensor_timer_fn(struct k_timer *timer);
+static K_TIMER_DEFINE(sensor_timer, sensor_timer_fn, NULL);
+
+/* Size of a CBOR encoded int32. */
+static size_t int_size(int32_t value)
+{
+	uint32_t magnitude = value < 0 ? -(value + 1) : value;
+
+	return magnitude < 24 ? 1 : magnitude <= UINT8_MAX ? 2 : magnitude <= UINT16_MAX ? 3 : 5;
+}
+
+static bool batch_empty(const struct batch *b)
+{
+	return b->msg.sample_count == 0 && b->msg.button == 0;
+}
+
+/* Must be called with lock held. */
+static int64_t batch_remaining_ms(void)
+{
+	return MAX(CONFIG_MQTT_SAMPLE_COALESCE_WINDOW_MS - (k_uptime_get() - batch.first_sample), 0);
+}
+
+/* Must be called with lock held. */
+static void batch_hand_over(enum flush_reason reason)
+{
+	pending = batch;
+	pending.reason = reason;
+	memset(&batch, 0, sizeof(batch));
+}
+
+/* Must be called with lock held. */
+static void flush_request(enum flush_reason reason)
+{
+	batch.reason = reason;
+	batch.flushing = true;
+
+	/* While the previous batch is still pending this one follows right after it. */
+	if (batch_empty(&pending)) {
+		batch_hand_over(reason);
+	}
+
+	(void)k_work_reschedule_for_queue(mqtt_work_q(), &flush_work, K_NO_WAIT);
+}
+
+static void flush_work_fn(struct k_work *work)
+{
+	int err;
+	size_t len;
+	uint32_t delay_ms;
+	struct batch out;
+	static uint8_t buf[TELEMETRY_CBOR_MAX_SIZE];
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	if (batch_empty(&pending)) {
+		if (batch_empty(&batch)) {
+			k_spin_unlock(&lock, key);
+			return;
+		}
+
+		if (batch.flushing) {
+			batch_hand_over(batch.reason);
+		} else if (batch_remaining_ms() == 0) {
+			batch_hand_over(FLUSH_DEADLINE);
+		} else {
+			/* Still scheduled for the deadline of an earlier batch */
+			(void)k_work_reschedule_for_queue(mqtt_work_q(), &flush_work,
+							  K_MSEC(batch_remaining_ms()));
+			k_spin_unlock(&lock, key);
+			return;
+		}
+	}
+
+	out = pending;
+	delay_ms = (uint32_t)(k_uptime_get() - out.first_sample);
+	memset(&pending, 0, sizeof(pending));
+
+	/* The next batch may have started or even filled up while this one was pending. */
+	if (!batch_empty(&batch)) {
+		(void)k_work_reschedule_for_queue(mqtt_work_q(), &flush_work,
+						  batch.flushing ? K_NO_WAIT :
+						  K_MSEC(batch_remaining_ms()));
+	}
+
+	k_spin_unlock(&lock, key);
+
+	out.msg.seq = seq++;
+
+	err = telemetry_cbor_encode(&out.msg, buf, sizeof(buf), &len);
+	if (err) {
+		LOG_ERR("Failed to encode batch, err: %d", err);
+		return;
+	}
+
+	err = publish_fn(buf, len);
+	if (err) {
+		LOG_WRN("Failed to publish batch of %d samples, err: %d", out.msg.sample_count, err);
+	}
+
+	key = k_spin_lock(&lock);
+
+	if (err) {
+		stats.dropped += out.msg.sample_count;
+		k_spin_unlock(&lock, key);
+		return;
+	}
+
+	stats.batches++;
+	stats.samples += out.msg.sample_count;
+	stats.payload_bytes += len;
+	stats.wire_bytes += len + WIRE_OVERHEAD;
+	/* Each sample on its own: the same message header with a one-element sample array. */
+	stats.wire_bytes_uncoalesced += out.msg.sample_count *
+					(len - out.samples_size + WIRE_OVERHEAD) +
+					out.samples_size;
+	stats.max_delay_ms = MAX(stats.max_delay_ms, delay_ms);
+
+	switch (out.reason) {
+	case FLUSH_DEADLINE:
+		stats.flush_deadline++;
+		break;
+	case FLUSH_COUNT:
+		stats.flush_count++;
+		break;
+	case FLUSH_SIZE:
+		stats.flush_size++;
+		break;
+	case FLUSH_EVENT:
+		stats.flush_event++;
+		break;
+	}
+
+	k_spin_unlock(&lock, key);
+}
+
+int coalesce_add(int32_t sample)
+{
+	size_t size = int_size(sample);
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	if (batch.msg.sample_count == CONFIG_MQTT_SAMPLE_COALESCE_MAX_SAMPLES) {
+		/* Full and waiting behind the pending batch */
+		stats.dropped++;
+		k_spin_unlock(&lock, key);
+		return -ENOBUFS;
+	}
+
+	if (batch_empty(&batch)) {
+		batch.first_sample = k_uptime_get();
+		batch.msg.uptime_ms = (uint32_t)batch.first_sample;
+		(void)k_work_schedule_for_queue(mqtt_work_q(), &flush_work,
+						K_MSEC(CONFIG_MQTT_SAMPLE_COALESCE_WINDOW_MS));
+	}
+
+	batch.msg.samples[batch.msg.sample_count++] = sample;
+	batch.samples_size += size;
+
+	if (batch.msg.sample_count == CONFIG_MQTT_SAMPLE_COALESCE_MAX_SAMPLES) {
+		flush_request(FLUSH_COUNT);
+	} else if (batch.samples_size >= CONFIG_MQTT_SAMPLE_COALESCE_MAX_BYTES) {
+		flush_request(FLUSH_SIZE);
+	}
+
+	k_spin_unlock(&lock, key);
+	return 0;
+}
+
+int coalesce_event(uint8_t button)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	if (batch.msg.button != 0) {
+		/* Only one event fits in a batch, let the pending one go first. */
+		k_spin_unlock(&lock, key);
+		return -EAGAIN;
+	}
+
+	if (batch.msg.sample_count == 0) {
+		batch.first_sample = k_uptime_get();
+		batch.msg.uptime_ms = (uint32_t)batch.first_sample;
+		(void)k_work_schedule_for_queue(mqtt_work_q(), &flush_work,
+						K_MSEC(CONFIG_MQTT_SAMPLE_COALESCE_WINDOW_MS));
+	}
+
+	batch.msg.button = button;
+
+	if (IS_ENABLED(CONFIG_MQTT_SAMPLE_COALESCE_FLUSH_ON_EVENT)) {
+		flush_request(FLUSH_EVENT);
+	}
+
+	k_spin_unlock(&lock, key);
+	return 0;
+}
+
+static void sensor_timer_fn(struct k_timer *timer)
+{
+	/* Stand-in for a real sensor, values spread over the CBOR integer sizes. */
+	(void)coalesce_add((int32_t)(sys_rand32_get() % 2000) - 1000);
+}
+
+void coalesce_sensor_set(bool enable)
+{
+	if (!enable || CONFIG_MQTT_SAMPLE_COALESCE_RATE_HZ == 0) {
+		k_timer_stop(&sensor_timer);
+		return;
+	}
+
+	k_timer_start(&sensor_timer, K_USEC(USEC_PER_SEC / CONFIG_MQTT_SAMPLE_COALESCE_RATE_HZ),
+		      K_USEC(USEC_PER_SEC / CONFIG_MQTT_SAMPLE_COALESCE_RATE_HZ));
+}
+
+static void report_work_fn(struct k_work *work)
+{
+	coalesce_stats_log();
+	(void)k_work_reschedule(&report_work,
+				K_SECONDS(CONFIG_MQTT_SAMPLE_COALESCE_REPORT_INTERVAL_S));
+}
+
+int coalesce_init(coalesce_publish_t publish)
+{
+	if (!publish) {
+		return -EINVAL;
+	}
+
+	publish_fn = publish;
+	(void)k_work_reschedule(&report_work,
+				K_SECONDS(CONFIG_MQTT_SAMPLE_COALESCE_REPORT_INTERVAL_S));
+
+	return 0;
+}
+
+void coalesce_stats_get(struct coalesce_stats *out)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	*out = stats;
+	k_spin_unlock(&lock, key);
+}
+
+void coalesce_stats_log(void)
+{
+	struct coalesce_stats s;
+
+	coalesce_stats_get(&s);
+
+	if (s.samples == 0) {
+		LOG_INF("No samples published yet, %d dropped", s.dropped);
+		return;
+	}
+
+	LOG_INF("%d samples in %d batches, %d dropped, max delay %d ms", s.samples, s.batches,
+		s.dropped, s.max_delay_ms);
+	LOG_INF("Flushed by deadline: %d, count: %d, size: %d, event: %d", s.flush_deadline,
+		s.flush_count, s.flush_size, s.flush_event);
+	LOG_INF("Bytes/sample: payload %d, wire %d, wire without coalescing %d",
+		(uint32_t)(s.payload_bytes / s.samples), (uint32_t)(s.wire_bytes / s.samples),
+		(uint32_t)(s.wire_bytes_uncoalesced / s.samples));
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef COALESCE_H_
+#define COALESCE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief Function that publishes an encoded batch. */
+typedef int (*coalesce_publish_t)(uint8_t *data, size_t len);
+
+/** @brief Counters kept by the coalescing stage. */
+struct coalesce_stats {
+	uint32_t samples;
+	uint32_t batches;
+	uint32_t dropped;
+	/* Batches flushed by each trigger. */
+	uint32_t flush_deadline;
+	uint32_t flush_count;
+	uint32_t flush_size;
+	uint32_t flush_event;
+	uint32_t max_delay_ms;
+	uint64_t payload_bytes;
+	/* Payload, MQTT, TLS and TCP/IP bytes, estimated from the framing of each message. */
+	uint64_t wire_bytes;
+	/* Wire bytes the same samples would have needed as one message each. */
+	uint64_t wire_bytes_uncoalesced;
+};
+
+/**
+ * @brief Initialize the coalescing stage.
+ *
+ * @param publish Called from the MQTT work queue, see mqtt_work_q(), with each encoded batch.
+ */
+int coalesce_init(coalesce_publish_t publish);
+
+/**
+ * @brief Add a sample to the current batch. Safe to call from interrupts.
+ *
+ * The batch is flushed CONFIG_MQTT_SAMPLE_COALESCE_WINDOW_MS after its first sample at the
+ * latest, or earlier when it reaches CONFIG_MQTT_SAMPLE_COALESCE_MAX_SAMPLES samples or
+ * CONFIG_MQTT_SAMPLE_COALESCE_MAX_BYTES encoded bytes.
+ *
+ * @retval 0 on success.
+ * @retval -ENOBUFS if the batch is full and the previous one is still waiting to be published.
+ *                  The sample is dropped.
+ */
+int coalesce_add(int32_t sample);
+
+/**
+ * @brief Record a button event in the current batch.
+ *
+ * The batch is flushed immediately if CONFIG_MQTT_SAMPLE_COALESCE_FLUSH_ON_EVENT is enabled,
+ * otherwise the event goes out with the batch when it is due.
+ */
+int coalesce_event(uint8_t button);
+
+/** @brief Start or stop the simulated sensor that feeds CONFIG_MQTT_SAMPLE_COALESCE_RATE_HZ. */
+void coalesce_sensor_set(bool enable);
+
+void coalesce_stats_get(struct coalesce_stats *stats);
+
+void coalesce_stats_log(void);
+
+#endif /* COALESCE_H_ */
@@ -18,13 +18,34 @@
 #include <zephyr/net/wifi_mgmt.h>
 #include <zephyr/net/wifi_credentials.h>
 #include <zephyr/net/socket.h>
+#include <zephyr/net/conn_mgr_monitor.h>
 #include <net/mqtt_helper.h>
 
+#include "mqtt_inflight.h"
+#include "mqtt_work.h"
+#include "client_id.h"
+#include "telemetry_cbor.h"
+#include "mqtt_bench.h"
+#include "mqtt_ps_sched.h"
+#include "sn_client.h"
+#include "coalesce.h"
+#include "blob_rx.h"
+#include "tls_stats.h"
+#include "broker_select.h"
+#include "topic_trie.h"
+#include "rate_limit.h"
+
 LOG_MODULE_REGISTER(Lesson4_Exercise2, LOG_LEVEL_INF);
 
 #define EVENT_MASK (NET_EVENT_L4_CONNECTED | NET_EVENT_L4_DISCONNECTED)
 
+#if defined(CONFIG_MQTT_SAMPLE_CBOR)
+#define MESSAGE_BUFFER_SIZE TELEMETRY_CBOR_MAX_SIZE
+BUILD_ASSERT(TELEMETRY_CBOR_MAX_SIZE <= CONFIG_MQTT_SAMPLE_PAYLOAD_SIZE,
+	     "CONFIG_MQTT_SAMPLE_PAYLOAD_SIZE cannot hold a full telemetry message");
+#else
 #define MESSAGE_BUFFER_SIZE 128
+#endif
 
 #define LED1_ON_CMD       "LED1ON"
 #define LED1_OFF_CMD      "LED1OFF"
@@ -40,6 +61,26 @@ static bool connected;
 static K_SEM_DEFINE(run_app, 0, 1);
 
 static uint8_t client_id[sizeof(CONFIG_BOARD) + 11];
+static int64_t connect_start;
+
+#if defined(CONFIG_MQTT_SAMPLE_BROKER_FAILOVER)
+static char broker_host[BROKER_SELECT_HOSTNAME_LEN];
+#else
+static char broker_host[] = CONFIG_MQTT_SAMPLE_BROKER_HOSTNAME;
+#endif
+
+#if defined(CONFIG_MQTT_SAMPLE_BROKER_FAILOVER)
+/* Probing and connecting block for seconds, so they get a queue of their own. */
+static struct k_work_q connect_work_q;
+static K_THREAD_STACK_DEFINE(connect_work_q_stack, CONFIG_MQTT_SAMPLE_BROKER_CONNECT_STACK_SIZE);
+static void connect_work_fn(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(connect_work, connect_work_fn);
+static bool failover;
+#endif
+
+#if defined(CONFIG_MQTT_SAMPLE_TOPIC_TRIE)
+TOPIC_TRIE_DEFINE(routes, CONFIG_MQTT_SAMPLE_TOPIC_TRIE_NODES);
+#endif
 
 
 static void net_mgmt_event_handler(struct net_mgmt_event_callback *cb, uint64_t mgmt_event,
@@ -60,7 +101,9 @@ static void net_mgmt_event_handler(struct net_mgmt_event_callback *cb, uint64_t
 		} else {
 			LOG_INF("Network disconnected");
 			connected = false;
-			(void)mqtt_helper_disconnect();
+			if (!IS_ENABLED(CONFIG_MQTT_SAMPLE_SN)) {
+				(void)mqtt_helper_disconnect();
+			}
 		}
 		k_sem_reset(&run_app);
 		return;
@@ -71,16 +114,31 @@ static void subscribe(void)
 {
 	int err;
 
-	struct mqtt_topic subscribe_topic = {
+	size_t count = 0;
+	struct mqtt_topic subscribe_topic[2];
+
+	subscribe_topic[count++] = (struct mqtt_topic) {
 		.topic = {
-			.utf8 = CONFIG_MQTT_SAMPLE_SUB_TOPIC, 
+			.utf8 = CONFIG_MQTT_SAMPLE_SUB_TOPIC,
 			.size = strlen(CONFIG_MQTT_SAMPLE_SUB_TOPIC)
 		},
-		.qos = MQTT_QOS_1_AT_LEAST_ONCE};
+		.qos = MQTT_QOS_1_AT_LEAST_ONCE
+	};
+
+	/* The benchmark receives its own messages back from the broker */
+	if (IS_ENABLED(CONFIG_MQTT_SAMPLE_BENCH)) {
+		subscribe_topic[count++] = (struct mqtt_topic) {
+			.topic = {
+				.utf8 = CONFIG_MQTT_SAMPLE_PUB_TOPIC,
+				.size = strlen(CONFIG_MQTT_SAMPLE_PUB_TOPIC)
+			},
+			.qos = MQTT_QOS_1_AT_LEAST_ONCE
+		};
+	}
 
 	struct mqtt_subscription_list subscription_list = {
-		.list = &subscribe_topic,
-		.list_count = 1,
+		.list = subscribe_topic,
+		.list_count = count,
 		.message_id = SUBSCRIBE_TOPIC_ID};
 
 	LOG_INF("Subscribing to %s", CONFIG_MQTT_SAMPLE_SUB_TOPIC);
@@ -91,11 +149,37 @@ static void subscribe(void)
 	}
 }
 
-static int publish(uint8_t *data, size_t len)
+static int publish_send(struct mqtt_publish_param *param)
+{
+	if (IS_ENABLED(CONFIG_MQTT_SAMPLE_INFLIGHT)) {
+		return mqtt_inflight_publish(param, K_NO_WAIT);
+	}
+
+	return mqtt_helper_publish(param);
+}
+
+static int publish_scheduled(struct mqtt_publish_param *param)
+{
+	if (IS_ENABLED(CONFIG_MQTT_SAMPLE_PS_SCHED)) {
+		return mqtt_ps_sched_publish(param);
+	}
+
+	return publish_send(param);
+}
+
+static int publish_lane(uint8_t *data, size_t len, enum rate_lane lane)
 {
 	int err;
 	struct mqtt_publish_param mqtt_param;
 
+	if (IS_ENABLED(CONFIG_MQTT_SAMPLE_SN)) {
+		err = sn_client_publish(data, len);
+		if (err) {
+			LOG_WRN("Failed to send payload, err: %d", err);
+		}
+		return err;
+	}
+
 	mqtt_param.message.payload.data = data;
 	mqtt_param.message.payload.len = len;
 	mqtt_param.message.topic.qos = MQTT_QOS_1_AT_LEAST_ONCE;
@@ -105,12 +189,33 @@ static int publish(uint8_t *data, size_t len)
 	mqtt_param.dup_flag = 0;
 	mqtt_param.retain_flag = 0;
 
-	err = mqtt_helper_publish(&mqtt_param);
-	if (err) {
+	if (IS_ENABLED(CONFIG_MQTT_SAMPLE_RATE_LIMIT)) {
+		err = rate_limit_publish(&mqtt_param, lane);
+	} else {
+		err = publish_scheduled(&mqtt_param);
+	}
+	if (err < 0) {
 		LOG_WRN("Failed to send payload, err: %d", err);
 		return err;
 	}
 
+	if (err == RATE_LIMIT_QUEUED) {
+		LOG_INF("Rate limited, queued %d byte message on topic: \"%.*s\"",
+			mqtt_param.message.payload.len,
+			mqtt_param.message.topic.topic.size,
+			mqtt_param.message.topic.topic.utf8);
+		return 0;
+	}
+
+	if (IS_ENABLED(CONFIG_MQTT_SAMPLE_CBOR)) {
+		LOG_INF("Published %d byte CBOR message on topic: \"%.*s\"",
+			mqtt_param.message.payload.len,
+			mqtt_param.message.topic.topic.size,
+			mqtt_param.message.topic.topic.utf8);
+		LOG_HEXDUMP_DBG(data, len, "CBOR payload");
+		return 0;
+	}
+
 	LOG_INF("Published message: \"%.*s\" on topic: \"%.*s\"", mqtt_param.message.payload.len,
 								  mqtt_param.message.payload.data,
 								  mqtt_param.message.topic.topic.size,
@@ -118,15 +223,87 @@ static int publish(uint8_t *data, size_t len)
 	return 0;
 }
 
+static int publish(uint8_t *data, size_t len)
+{
+	return publish_lane(data, len, RATE_LANE_TELEMETRY);
+}
+
+static int publish_button(uint8_t button, const char *msg, size_t len)
+{
+#if defined(CONFIG_MQTT_SAMPLE_CBOR)
+	int err;
+	size_t cbor_len;
+	static uint32_t seq;
+	static uint8_t cbor_buf[MESSAGE_BUFFER_SIZE];
+	struct telemetry_msg telemetry = {0};
+
+	if (IS_ENABLED(CONFIG_MQTT_SAMPLE_COALESCE)) {
+		return coalesce_event(button);
+	}
+
+	telemetry.seq = seq++;
+	telemetry.uptime_ms = k_uptime_get_32();
+	telemetry.button = button;
+
+	err = telemetry_cbor_encode(&telemetry, cbor_buf, sizeof(cbor_buf), &cbor_len);
+	if (err) {
+		LOG_ERR("Failed to encode telemetry, err: %d", err);
+		return err;
+	}
+
+	return publish_lane(cbor_buf, cbor_len, RATE_LANE_CONTROL);
+#else
+	ARG_UNUSED(button);
+
+	return publish_lane((uint8_t *)msg, len, RATE_LANE_CONTROL);
+#endif
+}
+
 static void on_mqtt_connack(enum mqtt_conn_return_code return_code, bool session_present)
 {
 	if (return_code == MQTT_CONNECTION_ACCEPTED) {
-		LOG_INF("Connected to MQTT broker");
-		LOG_INF("Hostname: %s", CONFIG_MQTT_SAMPLE_BROKER_HOSTNAME);
+		LOG_INF("Connected to MQTT broker in %lld ms", k_uptime_get() - connect_start);
+		LOG_INF("Hostname: %s", broker_host);
 		LOG_INF("Client ID: %s", (char *)client_id);
+#if defined(CONFIG_MQTT_HELPER)
+		/* MQTT-SN builds leave the helper out */
 		LOG_INF("Port: %d", CONFIG_MQTT_HELPER_PORT);
+#endif
 		LOG_INF("TLS: %s", IS_ENABLED(CONFIG_MQTT_LIB_TLS) ? "Yes" : "No");
-		subscribe();
+
+		if (IS_ENABLED(CONFIG_MQTT_SAMPLE_TLS_STATS)) {
+			tls_stats_log();
+		}
+
+		if (IS_ENABLED(CONFIG_MQTT_SAMPLE_BROKER_FAILOVER)) {
+			broker_select_confirm();
+		}
+
+		if (session_present) {
+			LOG_INF("Session present, keeping existing subscriptions");
+
+			if (IS_ENABLED(CONFIG_MQTT_SAMPLE_BENCH)) {
+				mqtt_bench_start();
+			}
+		} else {
+			subscribe();
+		}
+
+		if (IS_ENABLED(CONFIG_MQTT_SAMPLE_BLOB)) {
+			(void)blob_rx_start(broker_host);
+		}
+
+		if (IS_ENABLED(CONFIG_MQTT_SAMPLE_INFLIGHT)) {
+			mqtt_inflight_resend_all();
+		}
+
+		if (IS_ENABLED(CONFIG_MQTT_SAMPLE_COALESCE)) {
+			coalesce_sensor_set(true);
+		}
+
+		if (IS_ENABLED(CONFIG_MQTT_SAMPLE_PS_SCHED)) {
+			mqtt_ps_sched_connected_set(true);
+		}
 	} else {
 		LOG_WRN("Connection to broker not established, return_code: %d", return_code);
 	}
@@ -137,6 +314,10 @@ static void on_mqtt_suback(uint16_t message_id, int result)
 	if (result != MQTT_SUBACK_FAILURE) {
 		if (message_id == SUBSCRIBE_TOPIC_ID) {
 			LOG_INF("Subscribed to %s with QoS %d", CONFIG_MQTT_SAMPLE_SUB_TOPIC, result);
+
+			if (IS_ENABLED(CONFIG_MQTT_SAMPLE_BENCH)) {
+				mqtt_bench_start();
+			}
 			return;
 		}
 		LOG_WRN("Subscribed to unknown topic, id: %d with QoS %d", message_id, result);
@@ -145,13 +326,40 @@ static void on_mqtt_suback(uint16_t message_id, int result)
 	LOG_ERR("Topic subscription failed, error: %d", result);
 }
 
-static void on_mqtt_publish(struct mqtt_helper_buf topic, struct mqtt_helper_buf payload)
+static void on_mqtt_puback(uint16_t message_id, int result)
 {
-	LOG_INF("Received payload: %.*s on topic: %.*s", payload.size,
-							 payload.ptr,
-							 topic.size,
-							 topic.ptr);
-	
+	if (IS_ENABLED(CONFIG_MQTT_SAMPLE_BENCH)) {
+		mqtt_bench_on_puback(message_id);
+	}
+
+	if (IS_ENABLED(CONFIG_MQTT_SAMPLE_INFLIGHT)) {
+		int latency = mqtt_inflight_ack(message_id);
+
+		if (latency >= 0) {
+			LOG_DBG("PUBACK for message %d after %d ms", message_id, latency);
+		}
+		return;
+	}
+
+	LOG_DBG("PUBACK for message %d, result: %d", message_id, result);
+}
+
+static void led_command_handle(struct mqtt_helper_buf topic, struct mqtt_helper_buf payload,
+			       void *user_data)
+{
+	if (IS_ENABLED(CONFIG_MQTT_SAMPLE_CBOR)) {
+		struct led_command cmd;
+
+		if (led_command_cbor_decode(payload.ptr, payload.size, &cmd) == 0) {
+			if (cmd.led == 1 || cmd.led == 2) {
+				dk_set_led(cmd.led == 1 ? DK_LED1 : DK_LED2, cmd.on);
+			} else {
+				LOG_WRN("Unknown LED in command: %d", cmd.led);
+			}
+			return;
+		}
+	}
+
 	if (strncmp(payload.ptr, LED1_ON_CMD,
 			    sizeof(LED1_ON_CMD) - 1) == 0) {
 				dk_set_led_on(DK_LED1);
@@ -167,21 +375,119 @@ static void on_mqtt_publish(struct mqtt_helper_buf topic, struct mqtt_helper_buf
 	}
 }
 
+static void on_mqtt_publish(struct mqtt_helper_buf topic, struct mqtt_helper_buf payload)
+{
+	if (IS_ENABLED(CONFIG_MQTT_SAMPLE_BENCH) && mqtt_bench_on_publish(topic, payload)) {
+		return;
+	}
+
+	LOG_INF("Received payload: %.*s on topic: %.*s", payload.size,
+							 payload.ptr,
+							 topic.size,
+							 topic.ptr);
+
+#if defined(CONFIG_MQTT_SAMPLE_TOPIC_TRIE)
+	if (topic_trie_dispatch(&routes, topic, payload) == 0) {
+		LOG_WRN("No handler for topic: %.*s", topic.size, topic.ptr);
+	}
+#else
+	led_command_handle(topic, payload, NULL);
+#endif
+}
+
 static void on_mqtt_disconnect(int result)
 {
 	LOG_INF("MQTT client disconnected: %d", result);
+
+	if (IS_ENABLED(CONFIG_MQTT_SAMPLE_PS_SCHED)) {
+		mqtt_ps_sched_connected_set(false);
+	}
+
+	if (IS_ENABLED(CONFIG_MQTT_SAMPLE_COALESCE)) {
+		coalesce_sensor_set(false);
+		coalesce_stats_log();
+	}
+
+	if (IS_ENABLED(CONFIG_MQTT_SAMPLE_INFLIGHT)) {
+		mqtt_inflight_stats_log();
+	}
+
+	if (IS_ENABLED(CONFIG_MQTT_SAMPLE_RATE_LIMIT)) {
+		rate_limit_stats_log();
+	}
+
+#if defined(CONFIG_MQTT_SAMPLE_BROKER_FAILOVER)
+	/* A rejected connection or a lost broker while the network is up */
+	if (connected) {
+		failover = true;
+		(void)k_work_reschedule_for_queue(&connect_work_q, &connect_work, K_NO_WAIT);
+	}
+#endif
 }
 
+static int broker_connect(void)
+{
+	int err;
+	struct mqtt_helper_conn_params conn_params = {
+		.hostname.ptr = broker_host,
+		.hostname.size = strlen(broker_host),
+		.device_id.ptr = (char *)client_id,
+		.device_id.size = strlen(client_id),
+	};
+
+	if (IS_ENABLED(CONFIG_MQTT_SAMPLE_TLS_STATS)) {
+		tls_stats_connect_start();
+	}
+
+	connect_start = k_uptime_get();
+	err = mqtt_helper_connect(&conn_params);
+
+	if (IS_ENABLED(CONFIG_MQTT_SAMPLE_TLS_STATS)) {
+		tls_stats_connect_done();
+	}
+
+	return err;
+}
+
+#if defined(CONFIG_MQTT_SAMPLE_BROKER_FAILOVER)
+static void connect_work_fn(struct k_work *work)
+{
+	int err;
+
+	if (failover) {
+		err = broker_select_next(broker_host, sizeof(broker_host));
+		if (err) {
+			LOG_WRN("No broker reachable, retrying in %d ms",
+				CONFIG_MQTT_SAMPLE_BROKER_RETRY_MS);
+			(void)k_work_reschedule_for_queue(&connect_work_q, &connect_work,
+							  K_MSEC(CONFIG_MQTT_SAMPLE_BROKER_RETRY_MS));
+			return;
+		}
+	}
+
+	err = broker_connect();
+	if (err) {
+		LOG_WRN("Failed to connect to %s, error: %d", broker_host, err);
+		failover = true;
+		(void)k_work_reschedule_for_queue(&connect_work_q, &connect_work,
+						  K_MSEC(CONFIG_MQTT_SAMPLE_BROKER_RETRY_MS));
+		return;
+	}
+
+	failover = false;
+}
+#endif
+
 static void button_handler(uint32_t button_state, uint32_t has_changed)
 {
 	if (has_changed & DK_BTN1_MSK && button_state & DK_BTN1_MSK) {
-		int err = publish(BUTTON1_MSG, sizeof(BUTTON1_MSG) - 1);
+		int err = publish_button(1, BUTTON1_MSG, sizeof(BUTTON1_MSG) - 1);
 		if (err) {
 			LOG_ERR("Failed to send message, %d", err);
 			return;
 		}
 	} else if (has_changed & DK_BTN2_MSK && button_state & DK_BTN2_MSK) {
-		int err = publish(BUTTON2_MSG, sizeof(BUTTON2_MSG) - 1);
+		int err = publish_button(2, BUTTON2_MSG, sizeof(BUTTON2_MSG) - 1);
 		if (err) {
 			LOG_ERR("Failed to send message, %d", err);
 			return;
@@ -189,25 +495,32 @@ static void button_handler(uint32_t button_state, uint32_t has_changed)
 	}
 }
 
-int main(void)
+static int sn_start(void)
 {
 	int err;
 
-	if (dk_leds_init() != 0) {
-		LOG_ERR("Failed to initialize the LED library");
+	err = sn_client_init(on_mqtt_publish);
+	if (err) {
+		LOG_ERR("Failed to initialize MQTT-SN client, error: %d", err);
+		return err;
 	}
 
-	/* Sleep to allow initialization of Wi-Fi driver */
-	k_sleep(K_SECONDS(1));
+	err = sn_client_connect();
+	if (err) {
+		LOG_ERR("Failed to connect to MQTT-SN gateway, error: %d", err);
+	}
 
-	net_mgmt_init_event_callback(&mgmt_cb, net_mgmt_event_handler, EVENT_MASK);
-	net_mgmt_add_event_callback(&mgmt_cb);
+	return err;
+}
 
-	LOG_INF("Waiting to connect to Wi-Fi");
-	k_sem_take(&run_app, K_FOREVER);
+static int mqtt_start(void)
+{
+	int err;
 
-	if (dk_buttons_init(button_handler) != 0) {
-		LOG_ERR("Failed to initialize the buttons library");
+	err = mqtt_work_init();
+	if (err) {
+		LOG_ERR("Failed to start the work queue, error: %d", err);
+		return err;
 	}
 
 	struct mqtt_helper_cfg config = {
@@ -215,6 +528,7 @@ int main(void)
 			.on_connack = on_mqtt_connack,
 			.on_disconnect = on_mqtt_disconnect,
 			.on_publish = on_mqtt_publish,
+			.on_puback = on_mqtt_puback,
 			.on_suback = on_mqtt_suback,
 		},
 	};
@@ -222,22 +536,111 @@ int main(void)
 	err = mqtt_helper_init(&config);
 	if (err) {
 		LOG_ERR("Failed to initialize MQTT helper, error: %d", err);
-		return 0;
+		return err;
 	}
 
-	uint32_t id = sys_rand32_get();
-	snprintf(client_id, sizeof(client_id), "%s-%010u", CONFIG_BOARD, id);
+	if (IS_ENABLED(CONFIG_MQTT_SAMPLE_PS_SCHED)) {
+		err = mqtt_ps_sched_init(publish_send);
+		if (err) {
+			LOG_ERR("Failed to initialize power save scheduler, error: %d", err);
+			return err;
+		}
+	}
 
-	struct mqtt_helper_conn_params conn_params = {
-		.hostname.ptr = CONFIG_MQTT_SAMPLE_BROKER_HOSTNAME,
-		.hostname.size = strlen(CONFIG_MQTT_SAMPLE_BROKER_HOSTNAME),
-		.device_id.ptr = (char *)client_id,
-		.device_id.size = strlen(client_id),
+	if (IS_ENABLED(CONFIG_MQTT_SAMPLE_RATE_LIMIT)) {
+		err = rate_limit_init(publish_scheduled);
+		if (err) {
+			LOG_ERR("Failed to initialize rate limiter, error: %d", err);
+			return err;
+		}
+	}
+
+	if (IS_ENABLED(CONFIG_MQTT_SAMPLE_COALESCE)) {
+		err = coalesce_init(publish);
+		if (err) {
+			LOG_ERR("Failed to initialize coalescing stage, error: %d", err);
+			return err;
+		}
+	}
+
+	if (IS_ENABLED(CONFIG_MQTT_SAMPLE_PERSISTENT_SESSION)) {
+		err = client_id_get((char *)client_id, sizeof(client_id));
+		if (err) {
+			LOG_ERR("Failed to get stored client ID, error: %d", err);
+			return err;
+		}
+	} else {
+		uint32_t id = sys_rand32_get();
+		snprintf(client_id, sizeof(client_id), "%s-%010u", CONFIG_BOARD, id);
+	}
+
+#if defined(CONFIG_MQTT_SAMPLE_BROKER_FAILOVER)
+	err = broker_select_first(broker_host, sizeof(broker_host));
+	if (err) {
+		LOG_ERR("Failed to select a broker, error: %d", err);
+		return err;
+	}
+
+	struct k_work_queue_config connect_cfg = {
+		.name = "mqtt_connect",
 	};
 
-	err = mqtt_helper_connect(&conn_params);
+	k_work_queue_init(&connect_work_q);
+	k_work_queue_start(&connect_work_q, connect_work_q_stack,
+			   K_THREAD_STACK_SIZEOF(connect_work_q_stack),
+			   K_LOWEST_APPLICATION_THREAD_PRIO, &connect_cfg);
+
+	(void)k_work_reschedule_for_queue(&connect_work_q, &connect_work, K_NO_WAIT);
+	return 0;
+#else
+	err = broker_connect();
 	if (err) {
 		LOG_ERR("Failed to connect to MQTT, error code: %d", err);
+	}
+
+	return err;
+#endif
+}
+
+int main(void)
+{
+	if (dk_leds_init() != 0) {
+		LOG_ERR("Failed to initialize the LED library");
+	}
+
+	/* Sleep to allow initialization of Wi-Fi driver */
+	k_sleep(K_SECONDS(1));
+
+	net_mgmt_init_event_callback(&mgmt_cb, net_mgmt_event_handler, EVENT_MASK);
+	net_mgmt_add_event_callback(&mgmt_cb);
+
+	/* With a static address, e.g. on native_sim, L4 is up before the callback is added. */
+	conn_mgr_mon_resend_status();
+
+	LOG_INF("Waiting to connect to Wi-Fi");
+	k_sem_take(&run_app, K_FOREVER);
+
+	if (dk_buttons_init(button_handler) != 0) {
+		LOG_ERR("Failed to initialize the buttons library");
+	}
+
+#if defined(CONFIG_MQTT_SAMPLE_TOPIC_TRIE)
+	int err = topic_trie_add(&routes, CONFIG_MQTT_SAMPLE_SUB_TOPIC, led_command_handle, NULL);
+	if (err) {
+		LOG_ERR("Failed to add route for %s, error: %d", CONFIG_MQTT_SAMPLE_SUB_TOPIC, err);
 		return 0;
 	}
-}
\ No newline at end of file
+
+	if (IS_ENABLED(CONFIG_MQTT_SAMPLE_TOPIC_TRIE_BENCH)) {
+		topic_trie_bench_run();
+	}
+#endif
+
+	if (IS_ENABLED(CONFIG_MQTT_SAMPLE_SN)) {
+		(void)sn_start();
+	} else {
+		(void)mqtt_start();
+	}
+
+	return 0;
+}
@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+
+#include "mqtt_bench.h"
+
+LOG_MODULE_REGISTER(mqtt_bench, LOG_LEVEL_INF);
+
+#define BENCH_COUNT	   CONFIG_MQTT_SAMPLE_BENCH_COUNT
+#define BENCH_TOPIC	   CONFIG_MQTT_SAMPLE_PUB_TOPIC
+#define BENCH_MAGIC	   0x4d42454eU
+/* Payload starts with magic, sequence number and send time in microseconds, little endian. */
+#define BENCH_HEADER_SIZE  16
+#define PUBACK_PENDING_MAX 32
+/* No echo is awaited. */
+#define ECHO_NONE	   UINT32_MAX
+
+BUILD_ASSERT(CONFIG_MQTT_SAMPLE_BENCH_PAYLOAD_SIZE >= BENCH_HEADER_SIZE,
+	     "Benchmark payload must hold the sequence number and timestamp");
+
+struct puback_pending {
+	uint16_t message_id;
+	uint64_t sent_us;
+};
+
+static uint32_t rtt_us[BENCH_COUNT];
+static uint32_t puback_us[BENCH_COUNT];
+static uint32_t rtt_count;
+static uint32_t puback_count;
+static uint32_t duplicates;
+static struct puback_pending pending[PUBACK_PENDING_MAX];
+static uint8_t received[DIV_ROUND_UP(BENCH_COUNT, 8)];
+static uint8_t payload[CONFIG_MQTT_SAMPLE_BENCH_PAYLOAD_SIZE];
+/* Sequence number the closed loop waits for, so a late echo cannot end the next wait. */
+static uint32_t echo_awaited = ECHO_NONE;
+static atomic_t running;
+
+static K_SEM_DEFINE(bench_start_sem, 0, 1);
+static K_SEM_DEFINE(echo_sem, 0, 1);
+static K_MUTEX_DEFINE(bench_lock);
+
+static uint64_t now_us(void)
+{
+	return k_ticks_to_us_floor64(k_uptime_ticks());
+}
+
+static int compare_u32(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a;
+	uint32_t y = *(const uint32_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+static uint32_t percentile(const uint32_t *sorted, uint32_t count, uint32_t pct)
+{
+	if (count == 0) {
+		return 0;
+	}
+
+	return sorted[MIN((count * pct) / 100, count - 1)];
+}
+
+static void distribution_log(const char *name, uint32_t *samples, uint32_t count)
+{
+	uint64_t total = 0;
+
+	if (count == 0) {
+		LOG_INF("%s: no samples", name);
+		return;
+	}
+
+	qsort(samples, count, sizeof(samples[0]), compare_u32);
+
+	for (uint32_t i = 0; i < count; i++) {
+		total += samples[i];
+	}
+
+	LOG_INF("%s (us): min %u, p50 %u, p90 %u, p99 %u, max %u, avg %u", name, samples[0],
+		percentile(samples, count, 50), percentile(samples, count, 90),
+		percentile(samples, count, 99), samples[count - 1], (uint32_t)(total / count));
+}
+
+static void pending_add(uint16_t message_id, uint64_t sent_us)
+{
+	k_mutex_lock(&bench_lock, K_FOREVER);
+	pending[message_id % PUBACK_PENDING_MAX] = (struct puback_pending){
+		.message_id = message_id,
+		.sent_us = sent_us,
+	};
+	k_mutex_unlock(&bench_lock);
+}
+
+/* Set the echo the closed loop waits for, ECHO_NONE once the wait is over. */
+static void echo_await(uint32_t seq)
+{
+	k_mutex_lock(&bench_lock, K_FOREVER);
+	echo_awaited = seq;
+	k_mutex_unlock(&bench_lock);
+
+	if (seq == ECHO_NONE) {
+		/* Drop an echo that arrived after the wait timed out. */
+		k_sem_reset(&echo_sem);
+	}
+}
+
+static int bench_publish(uint32_t seq)
+{
+	int err;
+	uint64_t sent_us = now_us();
+	struct mqtt_publish_param param = {
+		.message.topic.qos = CONFIG_MQTT_SAMPLE_BENCH_QOS,
+		.message.topic.topic.utf8 = BENCH_TOPIC,
+		.message.topic.topic.size = sizeof(BENCH_TOPIC) - 1,
+		.message.payload.data = payload,
+		.message.payload.len = sizeof(payload),
+		.message_id = mqtt_helper_msg_id_get(),
+	};
+
+	sys_put_le32(BENCH_MAGIC, &payload[0]);
+	sys_put_le32(seq, &payload[4]);
+	sys_put_le64(sent_us, &payload[8]);
+
+	if (param.message.topic.qos != MQTT_QOS_0_AT_MOST_ONCE) {
+		pending_add(param.message_id, sent_us);
+	}
+
+	err = mqtt_helper_publish(&param);
+	if (err) {
+		LOG_WRN("Benchmark publish %u failed, err: %d", seq, err);
+	}
+
+	return err;
+}
+
+static void bench_reset(void)
+{
+	k_mutex_lock(&bench_lock, K_FOREVER);
+	rtt_count = 0;
+	puback_count = 0;
+	duplicates = 0;
+	memset(pending, 0, sizeof(pending));
+	memset(received, 0, sizeof(received));
+	memset(payload, 0xa5, sizeof(payload));
+	echo_awaited = ECHO_NONE;
+	k_mutex_unlock(&bench_lock);
+	k_sem_reset(&echo_sem);
+}
+
+static void bench_run(void)
+{
+	int err;
+	uint32_t sent = 0;
+	uint32_t failed = 0;
+	uint64_t start_us;
+	uint64_t elapsed_us;
+	int64_t next_ms = k_uptime_get();
+
+	bench_reset();
+
+	LOG_INF("Benchmark: %d messages of %d bytes, QoS %d, %s", BENCH_COUNT,
+		CONFIG_MQTT_SAMPLE_BENCH_PAYLOAD_SIZE, CONFIG_MQTT_SAMPLE_BENCH_QOS,
+		CONFIG_MQTT_SAMPLE_BENCH_RATE ? "fixed rate" : "closed loop");
+	if (CONFIG_MQTT_SAMPLE_BENCH_RATE) {
+		LOG_INF("Target rate: %d msgs/s", CONFIG_MQTT_SAMPLE_BENCH_RATE);
+	}
+
+	start_us = now_us();
+
+	for (uint32_t seq = 0; seq < BENCH_COUNT; seq++) {
+		if (!CONFIG_MQTT_SAMPLE_BENCH_RATE) {
+			/* Set before publishing, the echo can arrive before the publish returns. */
+			echo_await(seq);
+		}
+
+		err = bench_publish(seq);
+		if (err) {
+			failed++;
+		} else {
+			sent++;
+		}
+
+		if (CONFIG_MQTT_SAMPLE_BENCH_RATE) {
+			next_ms += MSEC_PER_SEC / MAX(CONFIG_MQTT_SAMPLE_BENCH_RATE, 1);
+			k_sleep(K_TIMEOUT_ABS_MS(next_ms));
+			continue;
+		}
+
+		if (!err && k_sem_take(&echo_sem, K_MSEC(CONFIG_MQTT_SAMPLE_BENCH_TIMEOUT_MS))) {
+			LOG_WRN("No echo for message %u", seq);
+		}
+
+		echo_await(ECHO_NONE);
+	}
+
+	/* Give the last messages time to come back. */
+	for (int i = 0; i < CONFIG_MQTT_SAMPLE_BENCH_TIMEOUT_MS / 100; i++) {
+		if (rtt_count >= sent) {
+			break;
+		}
+		k_sleep(K_MSEC(100));
+	}
+
+	k_mutex_lock(&bench_lock, K_FOREVER);
+	elapsed_us = now_us() - start_us;
+
+	LOG_INF("Benchmark done in %llu ms", elapsed_us / USEC_PER_MSEC);
+	LOG_INF("Sent: %u, failed: %u, received: %u, lost: %u, duplicates: %u", sent, failed,
+		rtt_count, sent - MIN(rtt_count, sent), duplicates);
+	LOG_INF("Throughput: %u msgs/s published, %u msgs/s received",
+		(uint32_t)((uint64_t)sent * USEC_PER_SEC / MAX(elapsed_us, 1)),
+		(uint32_t)((uint64_t)rtt_count * USEC_PER_SEC / MAX(elapsed_us, 1)));
+	distribution_log("Publish to receive RTT", rtt_us, rtt_count);
+	if (CONFIG_MQTT_SAMPLE_BENCH_QOS != MQTT_QOS_0_AT_MOST_ONCE) {
+		distribution_log("PUBACK latency", puback_us, puback_count);
+	}
+	k_mutex_unlock(&bench_lock);
+}
+
+static void bench_thread(void)
+{
+	while (true) {
+		k_sem_take(&bench_start_sem, K_FOREVER);
+		bench_run();
+		atomic_clear(&running);
+	}
+}
+
+K_THREAD_DEFINE(mqtt_bench_thread, CONFIG_MQTT_SAMPLE_BENCH_STACK_SIZE, bench_thread, NULL, NULL,
+		NULL, K_LOWEST_APPLICATION_THREAD_PRIO, 0, 0);
+
+void mqtt_bench_start(void)
+{
+	if (atomic_set(&running, 1)) {
+		return;
+	}
+
+	k_sem_give(&bench_start_sem);
+}
+
+bool mqtt_bench_on_publish(struct mqtt_helper_buf topic, struct mqtt_helper_buf buf)
+{
+	uint32_t seq;
+	uint64_t sent_us;
+	uint64_t now = now_us();
+
+	if (topic.size != sizeof(BENCH_TOPIC) - 1 || memcmp(topic.ptr, BENCH_TOPIC, topic.size) ||
+	    buf.size < BENCH_HEADER_SIZE || sys_get_le32((uint8_t *)buf.ptr) != BENCH_MAGIC) {
+		return false;
+	}
+
+	seq = sys_get_le32((uint8_t *)&buf.ptr[4]);
+	sent_us = sys_get_le64((uint8_t *)&buf.ptr[8]);
+
+	if (seq >= BENCH_COUNT) {
+		return true;
+	}
+
+	k_mutex_lock(&bench_lock, K_FOREVER);
+	if (received[seq / 8] & BIT(seq % 8)) {
+		duplicates++;
+	} else {
+		received[seq / 8] |= BIT(seq % 8);
+		rtt_us[rtt_count++] = (uint32_t)(now - sent_us);
+	}
+
+	if (seq == echo_awaited) {
+		echo_awaited = ECHO_NONE;
+		k_sem_give(&echo_sem);
+	}
+	k_mutex_unlock(&bench_lock);
+
+	return true;
+}
+
+void mqtt_bench_on_puback(uint16_t message_id)
+{
+	struct puback_pending *entry;
+	uint64_t now = now_us();
+
+	k_mutex_lock(&bench_lock, K_FOREVER);
+	entry = &pending[message_id % PUBACK_PENDING_MAX];
+	if (entry->sent_us != 0 && entry->message_id == message_id && puback_count < BENCH_COUNT) {
+		puback_us[puback_count++] = (uint32_t)(now - entry->sent_us);
+		entry->sent_us = 0;
+	}
+	k_mutex_unlock(&bench_lock);
+}
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef MQTT_BENCH_H_
+#define MQTT_BENCH_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <net/mqtt_helper.h>
+
+/**
+ * @brief Start a benchmark run.
+ *
+ * Must be called once the client is subscribed to CONFIG_MQTT_SAMPLE_PUB_TOPIC so that the
+ * benchmark messages are echoed back by the broker. Calls while a run is active are ignored.
+ */
+void mqtt_bench_start(void);
+
+/**
+ * @brief Pass a received message to the benchmark.
+ *
+ * @retval true if the message was a benchmark message and has been consumed.
+ * @retval false if the message should be handled by the application.
+ */
+bool mqtt_bench_on_publish(struct mqtt_helper_buf topic, struct mqtt_helper_buf payload);
+
+/** @brief Pass a PUBACK to the benchmark. */
+void mqtt_bench_on_puback(uint16_t message_id);
+
+#endif /* MQTT_BENCH_H_ */
@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "mqtt_inflight.h"
+#include "mqtt_work.h"
+
+LOG_MODULE_REGISTER(mqtt_inflight, LOG_LEVEL_INF);
+
+#define SLOT_COUNT CONFIG_MQTT_SAMPLE_INFLIGHT_WINDOW_MAX
+
+struct inflight_slot {
+	bool used;
+	uint8_t retries;
+	uint16_t message_id;
+	int64_t first_sent;
+	int64_t last_sent;
+	struct mqtt_publish_param param;
+	uint8_t payload[CONFIG_MQTT_SAMPLE_PAYLOAD_SIZE];
+};
+
+static struct inflight_slot slots[SLOT_COUNT];
+static uint16_t window = CONFIG_MQTT_SAMPLE_INFLIGHT_WINDOW;
+static uint16_t in_flight;
+static struct mqtt_inflight_stats stats;
+static uint64_t ack_latency_total_ms;
+
+static K_MUTEX_DEFINE(inflight_lock);
+static K_CONDVAR_DEFINE(slot_freed);
+
+static void retransmit_work_fn(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(retransmit_work, retransmit_work_fn);
+
+static void slot_release(struct inflight_slot *slot)
+{
+	slot->used = false;
+	in_flight--;
+	k_condvar_signal(&slot_freed);
+}
+
+static int slot_send(struct inflight_slot *slot, bool dup)
+{
+	slot->param.dup_flag = dup ? 1 : 0;
+	slot->last_sent = k_uptime_get();
+
+	return mqtt_helper_publish(&slot->param);
+}
+
+/* Must be called with inflight_lock held. */
+static void retransmit_schedule(void)
+{
+	int64_t now = k_uptime_get();
+	int64_t next = INT64_MAX;
+
+	for (size_t i = 0; i < ARRAY_SIZE(slots); i++) {
+		if (slots[i].used) {
+			next = MIN(next, slots[i].last_sent + CONFIG_MQTT_SAMPLE_INFLIGHT_RETRY_MS);
+		}
+	}
+
+	if (next == INT64_MAX) {
+		(void)k_work_cancel_delayable(&retransmit_work);
+		return;
+	}
+
+	(void)k_work_reschedule_for_queue(mqtt_work_q(), &retransmit_work,
+					  K_MSEC(MAX(next - now, 0)));
+}
+
+static void retransmit_work_fn(struct k_work *work)
+{
+	int err;
+	int64_t now = k_uptime_get();
+
+	k_mutex_lock(&inflight_lock, K_FOREVER);
+
+	for (size_t i = 0; i < ARRAY_SIZE(slots); i++) {
+		struct inflight_slot *slot = &slots[i];
+
+		if (!slot->used ||
+		    now - slot->last_sent < CONFIG_MQTT_SAMPLE_INFLIGHT_RETRY_MS) {
+			continue;
+		}
+
+		if (slot->retries >= CONFIG_MQTT_SAMPLE_INFLIGHT_MAX_RETRIES) {
+			LOG_WRN("No PUBACK for message %d after %d retries, dropping",
+				slot->message_id, slot->retries);
+			stats.dropped++;
+			slot_release(slot);
+			continue;
+		}
+
+		slot->retries++;
+		err = slot_send(slot, true);
+		if (err) {
+			LOG_WRN("Retransmission of message %d failed, err: %d", slot->message_id, err);
+			continue;
+		}
+
+		stats.retransmitted++;
+		LOG_DBG("Retransmitted message %d, attempt %d", slot->message_id, slot->retries);
+	}
+
+	retransmit_schedule();
+	k_mutex_unlock(&inflight_lock);
+}
+
+int mqtt_inflight_publish(struct mqtt_publish_param *param, k_timeout_t timeout)
+{
+	int err;
+	struct inflight_slot *slot = NULL;
+
+	if (param->message.topic.qos == MQTT_QOS_0_AT_MOST_ONCE) {
+		param->dup_flag = 0;
+		return mqtt_helper_publish(param);
+	}
+
+	if (param->message.payload.len > CONFIG_MQTT_SAMPLE_PAYLOAD_SIZE) {
+		return -EMSGSIZE;
+	}
+
+	k_mutex_lock(&inflight_lock, K_FOREVER);
+
+	while (in_flight >= window) {
+		err = k_condvar_wait(&slot_freed, &inflight_lock, timeout);
+		if (err) {
+			stats.window_full++;
+			k_mutex_unlock(&inflight_lock);
+			return -EAGAIN;
+		}
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(slots); i++) {
+		if (!slots[i].used) {
+			slot = &slots[i];
+			break;
+		}
+	}
+
+	__ASSERT_NO_MSG(slot != NULL);
+
+	memcpy(slot->payload, param->message.payload.data, param->message.payload.len);
+	slot->param = *param;
+	slot->param.message.payload.data = slot->payload;
+	/* Keep the ID the caller took, so that no ID is wasted. */
+	if (slot->param.message_id == 0) {
+		slot->param.message_id = mqtt_helper_msg_id_get();
+	}
+	slot->message_id = slot->param.message_id;
+	slot->retries = 0;
+
+	err = slot_send(slot, false);
+	if (err) {
+		k_mutex_unlock(&inflight_lock);
+		return err;
+	}
+
+	slot->used = true;
+	slot->first_sent = slot->last_sent;
+	in_flight++;
+	stats.sent++;
+	stats.max_in_flight = MAX(stats.max_in_flight, in_flight);
+	param->message_id = slot->message_id;
+
+	retransmit_schedule();
+	k_mutex_unlock(&inflight_lock);
+
+	return 0;
+}
+
+int mqtt_inflight_ack(uint16_t message_id)
+{
+	int latency = -ENOENT;
+
+	k_mutex_lock(&inflight_lock, K_FOREVER);
+
+	for (size_t i = 0; i < ARRAY_SIZE(slots); i++) {
+		if (slots[i].used && slots[i].message_id == message_id) {
+			latency = (int)(k_uptime_get() - slots[i].first_sent);
+			stats.acked++;
+			ack_latency_total_ms += latency;
+			stats.ack_latency_max_ms = MAX(stats.ack_latency_max_ms, latency);
+			slot_release(&slots[i]);
+			retransmit_schedule();
+			break;
+		}
+	}
+
+	k_mutex_unlock(&inflight_lock);
+
+	if (latency < 0) {
+		LOG_DBG("PUBACK for unknown message %d", message_id);
+	}
+
+	return latency;
+}
+
+void mqtt_inflight_resend_all(void)
+{
+	int err;
+
+	k_mutex_lock(&inflight_lock, K_FOREVER);
+
+	for (size_t i = 0; i < ARRAY_SIZE(slots); i++) {
+		if (!slots[i].used) {
+			continue;
+		}
+
+		err = slot_send(&slots[i], true);
+		if (err) {
+			LOG_WRN("Resending message %d failed, err: %d", slots[i].message_id, err);
+			continue;
+		}
+
+		stats.retransmitted++;
+	}
+
+	retransmit_schedule();
+	k_mutex_unlock(&inflight_lock);
+}
+
+int mqtt_inflight_window_set(uint16_t new_window)
+{
+	if (new_window == 0 || new_window > SLOT_COUNT) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&inflight_lock, K_FOREVER);
+	window = new_window;
+	k_condvar_broadcast(&slot_freed);
+	k_mutex_unlock(&inflight_lock);
+
+	LOG_INF("In-flight window set to %d", new_window);
+	return 0;
+}
+
+void mqtt_inflight_stats_get(struct mqtt_inflight_stats *out)
+{
+	k_mutex_lock(&inflight_lock, K_FOREVER);
+	*out = stats;
+	out->in_flight = in_flight;
+	out->window = window;
+	out->ack_latency_avg_ms = stats.acked ? (uint32_t)(ack_latency_total_ms / stats.acked) : 0;
+	k_mutex_unlock(&inflight_lock);
+}
+
+void mqtt_inflight_stats_log(void)
+{
+	struct mqtt_inflight_stats s;
+
+	mqtt_inflight_stats_get(&s);
+
+	LOG_INF("QoS 1 window: %d/%d in flight, max %d, full %d times", s.in_flight, s.window,
+		s.max_in_flight, s.window_full);
+	LOG_INF("Sent: %d, acked: %d, retransmitted: %d, dropped: %d", s.sent, s.acked,
+		s.retransmitted, s.dropped);
+	LOG_INF("PUBACK latency avg: %d ms, max: %d ms", s.ack_latency_avg_ms,
+		s.ack_latency_max_ms);
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef MQTT_INFLIGHT_H_
+#define MQTT_INFLIGHT_H_
+
+#include <stdint.h>
+#include <zephyr/kernel.h>
+#include <net/mqtt_helper.h>
+
+/** @brief Counters kept by the QoS 1 in-flight window. */
+struct mqtt_inflight_stats {
+	uint32_t sent;
+	uint32_t acked;
+	uint32_t retransmitted;
+	uint32_t dropped;
+	uint32_t window_full;
+	uint16_t in_flight;
+	uint16_t max_in_flight;
+	uint16_t window;
+	uint32_t ack_latency_avg_ms;
+	uint32_t ack_latency_max_ms;
+};
+
+/**
+ * @brief Publish a message through the in-flight window.
+ *
+ * QoS 1 messages keep the message ID set by the caller, or get one from mqtt_helper_msg_id_get()
+ * if it is 0. The payload is copied into a window slot and the slot is held until the matching
+ * PUBACK arrives. Messages that are not acknowledged within CONFIG_MQTT_SAMPLE_INFLIGHT_RETRY_MS
+ * are retransmitted with the DUP flag set from the sample work queue. QoS 0 messages are passed
+ * straight to the helper.
+ *
+ * The topic is not copied and must stay valid until the message is acknowledged.
+ *
+ * @param param   Publish parameters. dup_flag is set by the window, and message_id if it is 0.
+ * @param timeout How long to wait for a free slot when the window is full.
+ *
+ * @retval 0 on success.
+ * @retval -EAGAIN if the window stayed full for the whole timeout.
+ * @retval -EMSGSIZE if the payload does not fit in a window slot.
+ * @retval Other negative error codes from mqtt_helper_publish().
+ */
+int mqtt_inflight_publish(struct mqtt_publish_param *param, k_timeout_t timeout);
+
+/**
+ * @brief Release the window slot matching a PUBACK.
+ *
+ * @return Publish to PUBACK latency in milliseconds, or -ENOENT if no message with this ID is in
+ *	   flight.
+ */
+int mqtt_inflight_ack(uint16_t message_id);
+
+/** @brief Retransmit every unacknowledged message with DUP set, e.g. after a reconnect. */
+void mqtt_inflight_resend_all(void);
+
+/**
+ * @brief Change the number of unacknowledged messages allowed at once.
+ *
+ * @retval -EINVAL if the window is 0 or larger than CONFIG_MQTT_SAMPLE_INFLIGHT_WINDOW_MAX.
+ */
+int mqtt_inflight_window_set(uint16_t window);
+
+void mqtt_inflight_stats_get(struct mqtt_inflight_stats *stats);
+
+void mqtt_inflight_stats_log(void);
+
+#endif /* MQTT_INFLIGHT_H_ */
@@ -0,0 +1,343 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/net_mgmt.h>
+#include <zephyr/net/wifi_mgmt.h>
+
+#include "mqtt_ps_sched.h"
+#include "mqtt_work.h"
+
+LOG_MODULE_REGISTER(mqtt_ps_sched, LOG_LEVEL_INF);
+
+#define TWT_MGMT_EVENTS (NET_EVENT_WIFI_TWT | NET_EVENT_WIFI_TWT_SLEEP_STATE)
+
+#define KEEPALIVE_MS	  (CONFIG_MQTT_SAMPLE_PS_KEEPALIVE_S * MSEC_PER_SEC)
+#define EARLY_KEEPALIVE_MS (KEEPALIVE_MS * CONFIG_MQTT_SAMPLE_PS_EARLY_PERCENT / 100)
+#define HEARTBEAT_TOPIC	  CONFIG_MQTT_SAMPLE_PS_HEARTBEAT_TOPIC
+
+/* Transmissions this close to an induced wake are assumed to share it. */
+#define WAKE_MERGE_MS 100
+
+/* Earliest retry of a deadline whose send failed. */
+#define DEADLINE_RETRY_MS 1000
+
+BUILD_ASSERT(CONFIG_MQTT_SAMPLE_PS_KEEPALIVE_S < CONFIG_MQTT_KEEPALIVE,
+	     "The aligned keepalive must expire before the MQTT library sends its own PINGREQ");
+
+struct queued_msg {
+	int64_t queued_at;
+	struct mqtt_publish_param param;
+	uint8_t payload[CONFIG_MQTT_SAMPLE_PAYLOAD_SIZE];
+};
+
+K_MSGQ_DEFINE(ps_queue, sizeof(struct queued_msg), CONFIG_MQTT_SAMPLE_PS_QUEUE_SIZE, 4);
+
+static mqtt_ps_sched_send_t send_fn;
+static struct net_mgmt_event_callback twt_mgmt_cb;
+static bool connected;
+static bool twt_active;
+static bool awake;
+static bool align = IS_ENABLED(CONFIG_MQTT_SAMPLE_PS_ALIGN);
+static int64_t last_tx;
+static int64_t last_induced_wake;
+static int64_t oldest_queued_at;
+static struct mqtt_ps_sched_stats stats;
+
+static K_MUTEX_DEFINE(sched_lock);
+
+static void wake_work_fn(struct k_work *work);
+static void deadline_work_fn(struct k_work *work);
+static void report_work_fn(struct k_work *work);
+
+static K_WORK_DEFINE(wake_work, wake_work_fn);
+static K_WORK_DELAYABLE_DEFINE(deadline_work, deadline_work_fn);
+static K_WORK_DELAYABLE_DEFINE(report_work, report_work_fn);
+
+static bool in_wake_period(void)
+{
+	return twt_active && awake;
+}
+
+/* Must be called with sched_lock held. */
+static void account_tx(void)
+{
+	int64_t now = k_uptime_get();
+
+	if (in_wake_period()) {
+		stats.aligned_tx++;
+	} else if (now - last_induced_wake > WAKE_MERGE_MS) {
+		stats.induced_wakes++;
+		last_induced_wake = now;
+	}
+
+	last_tx = now;
+}
+
+/* Must be called with sched_lock held. */
+static int send_now(struct mqtt_publish_param *param)
+{
+	int err = send_fn(param);
+
+	if (!err) {
+		account_tx();
+	}
+
+	return err;
+}
+
+/* Must be called with sched_lock held. */
+static void queue_flush(void)
+{
+	int err;
+	int64_t now = k_uptime_get();
+	struct queued_msg msg;
+
+	while (k_msgq_get(&ps_queue, &msg, K_NO_WAIT) == 0) {
+		msg.param.message.payload.data = msg.payload;
+		stats.max_queue_delay_ms = MAX(stats.max_queue_delay_ms,
+					       (uint32_t)(now - msg.queued_at));
+
+		err = send_now(&msg.param);
+		if (err) {
+			LOG_WRN("Failed to send queued message, err: %d", err);
+		}
+	}
+
+	oldest_queued_at = 0;
+}
+
+/* Must be called with sched_lock held. */
+static void heartbeat_send(void)
+{
+	int err;
+	struct mqtt_publish_param param = {
+		.message.topic.qos = MQTT_QOS_0_AT_MOST_ONCE,
+		.message.topic.topic.utf8 = HEARTBEAT_TOPIC,
+		.message.topic.topic.size = sizeof(HEARTBEAT_TOPIC) - 1,
+	};
+
+	/* Any control packet resets the keepalive timers on both sides, so an empty QoS 0
+	 * publish in a wake period replaces the PINGREQ the MQTT library would send later.
+	 */
+	err = send_now(&param);
+	if (err) {
+		LOG_DBG("Heartbeat not sent, err: %d", err);
+		return;
+	}
+
+	stats.heartbeats++;
+}
+
+/* Must be called with sched_lock held. */
+static void deadline_reschedule(void)
+{
+	int64_t now = k_uptime_get();
+	int64_t next = last_tx + KEEPALIVE_MS;
+
+	if (!connected) {
+		(void)k_work_cancel_delayable(&deadline_work);
+		return;
+	}
+
+	if (oldest_queued_at != 0) {
+		next = MIN(next, oldest_queued_at + CONFIG_MQTT_SAMPLE_PS_MAX_DELAY_MS);
+	}
+
+	/* A deadline in the past means the send at the deadline failed, so back off instead of
+	 * running again at once.
+	 */
+	if (next <= now) {
+		next = now + DEADLINE_RETRY_MS;
+	}
+
+	(void)k_work_reschedule_for_queue(mqtt_work_q(), &deadline_work, K_TIMEOUT_ABS_MS(next));
+}
+
+static void wake_work_fn(struct k_work *work)
+{
+	k_mutex_lock(&sched_lock, K_FOREVER);
+
+	/* Keep the queue until the client is connected again. */
+	if (!connected) {
+		k_mutex_unlock(&sched_lock);
+		return;
+	}
+
+	queue_flush();
+
+	if (align && k_uptime_get() - last_tx >= EARLY_KEEPALIVE_MS) {
+		heartbeat_send();
+	}
+
+	deadline_reschedule();
+	k_mutex_unlock(&sched_lock);
+}
+
+static void deadline_work_fn(struct k_work *work)
+{
+	int64_t now = k_uptime_get();
+
+	k_mutex_lock(&sched_lock, K_FOREVER);
+
+	if (oldest_queued_at != 0 &&
+	    now - oldest_queued_at >= CONFIG_MQTT_SAMPLE_PS_MAX_DELAY_MS) {
+		LOG_DBG("No wake period before the publish deadline, sending now");
+		queue_flush();
+	}
+
+	if (now - last_tx >= KEEPALIVE_MS) {
+		heartbeat_send();
+	}
+
+	deadline_reschedule();
+	k_mutex_unlock(&sched_lock);
+}
+
+static void report_work_fn(struct k_work *work)
+{
+	mqtt_ps_sched_stats_log();
+	(void)k_work_reschedule(&report_work, K_SECONDS(CONFIG_MQTT_SAMPLE_PS_REPORT_INTERVAL_S));
+}
+
+static void twt_event_handler(struct net_mgmt_event_callback *cb, uint64_t mgmt_event,
+			      struct net_if *iface)
+{
+	if (mgmt_event == NET_EVENT_WIFI_TWT) {
+		const struct wifi_twt_params *resp = (const struct wifi_twt_params *)cb->info;
+
+		if (resp->operation == WIFI_TWT_TEARDOWN) {
+			LOG_INF("TWT torn down, publishing without alignment");
+			twt_active = false;
+		} else if (resp->resp_status == WIFI_TWT_RESP_RECEIVED &&
+			   resp->setup_cmd == WIFI_TWT_SETUP_CMD_ACCEPT) {
+			LOG_INF("TWT set up, aligning MQTT traffic to wake periods");
+			twt_active = true;
+		}
+		return;
+	}
+
+	if (mgmt_event == NET_EVENT_WIFI_TWT_SLEEP_STATE) {
+		const int *state = (const int *)cb->info;
+
+		awake = (*state == WIFI_TWT_STATE_AWAKE);
+		if (awake) {
+			stats.twt_wake_periods++;
+			k_work_submit_to_queue(mqtt_work_q(), &wake_work);
+		}
+	}
+}
+
+int mqtt_ps_sched_init(mqtt_ps_sched_send_t send)
+{
+	if (send == NULL) {
+		return -EINVAL;
+	}
+
+	send_fn = send;
+	last_tx = k_uptime_get();
+
+	net_mgmt_init_event_callback(&twt_mgmt_cb, twt_event_handler, TWT_MGMT_EVENTS);
+	net_mgmt_add_event_callback(&twt_mgmt_cb);
+
+	(void)k_work_reschedule(&report_work, K_SECONDS(CONFIG_MQTT_SAMPLE_PS_REPORT_INTERVAL_S));
+
+	return 0;
+}
+
+int mqtt_ps_sched_publish(struct mqtt_publish_param *param)
+{
+	int err;
+	struct queued_msg msg;
+
+	if (param->message.payload.len > sizeof(msg.payload)) {
+		return -EMSGSIZE;
+	}
+
+	k_mutex_lock(&sched_lock, K_FOREVER);
+
+	if (!align || !twt_active || awake) {
+		queue_flush();
+		err = send_now(param);
+		deadline_reschedule();
+		k_mutex_unlock(&sched_lock);
+		return err;
+	}
+
+	msg.queued_at = k_uptime_get();
+	msg.param = *param;
+	memcpy(msg.payload, param->message.payload.data, param->message.payload.len);
+
+	err = k_msgq_put(&ps_queue, &msg, K_NO_WAIT);
+	if (err) {
+		stats.queue_full++;
+		k_mutex_unlock(&sched_lock);
+		return -ENOBUFS;
+	}
+
+	stats.queued++;
+	if (oldest_queued_at == 0) {
+		oldest_queued_at = msg.queued_at;
+		deadline_reschedule();
+	}
+
+	k_mutex_unlock(&sched_lock);
+	return 0;
+}
+
+void mqtt_ps_sched_connected_set(bool is_connected)
+{
+	k_mutex_lock(&sched_lock, K_FOREVER);
+
+	connected = is_connected;
+	if (connected) {
+		/* CONNECT restarted the keepalive timers on both sides. */
+		last_tx = k_uptime_get();
+	}
+
+	deadline_reschedule();
+	k_mutex_unlock(&sched_lock);
+}
+
+void mqtt_ps_sched_align_set(bool enable)
+{
+	k_mutex_lock(&sched_lock, K_FOREVER);
+	align = enable;
+	if (!align) {
+		queue_flush();
+	}
+	k_mutex_unlock(&sched_lock);
+
+	LOG_INF("Wake period alignment %s", enable ? "enabled" : "disabled");
+}
+
+void mqtt_ps_sched_stats_get(struct mqtt_ps_sched_stats *out)
+{
+	k_mutex_lock(&sched_lock, K_FOREVER);
+	*out = stats;
+	out->uptime_s = k_uptime_seconds();
+	k_mutex_unlock(&sched_lock);
+}
+
+void mqtt_ps_sched_stats_log(void)
+{
+	struct mqtt_ps_sched_stats s;
+	uint32_t hours_x100;
+
+	mqtt_ps_sched_stats_get(&s);
+	hours_x100 = MAX(s.uptime_s * 100 / SEC_PER_HOUR, 1);
+
+	LOG_INF("Alignment %s, TWT %s, %d wake periods", align ? "on" : "off",
+		twt_active ? "active" : "inactive", s.twt_wake_periods);
+	LOG_INF("Radio wakes caused by MQTT: %d (%d per hour)", s.induced_wakes,
+		s.induced_wakes * 100 / hours_x100);
+	LOG_INF("Sent in wake periods: %d, heartbeats: %d", s.aligned_tx, s.heartbeats);
+	LOG_INF("Queued: %d, queue full: %d, max queue delay: %d ms", s.queued, s.queue_full,
+		s.max_queue_delay_ms);
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef MQTT_PS_SCHED_H_
+#define MQTT_PS_SCHED_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <net/mqtt_helper.h>
+
+/** @brief Function used by the scheduler to put a message on the wire. */
+typedef int (*mqtt_ps_sched_send_t)(struct mqtt_publish_param *param);
+
+/** @brief Counters kept by the power-save-aligned scheduler. */
+struct mqtt_ps_sched_stats {
+	/* Transmissions that had to wake the radio outside a wake period. */
+	uint32_t induced_wakes;
+	/* Transmissions that went out during a TWT wake period. */
+	uint32_t aligned_tx;
+	uint32_t heartbeats;
+	uint32_t queued;
+	uint32_t queue_full;
+	uint32_t max_queue_delay_ms;
+	uint32_t twt_wake_periods;
+	uint32_t uptime_s;
+};
+
+/**
+ * @brief Initialize the scheduler.
+ *
+ * Registers for TWT net_mgmt events. The keepalive deadline timer runs on the sample work queue
+ * while the client is connected, see mqtt_ps_sched_connected_set().
+ *
+ * @param send Function that publishes a message immediately.
+ */
+int mqtt_ps_sched_init(mqtt_ps_sched_send_t send);
+
+/**
+ * @brief Publish now if the radio is in a wake period, otherwise queue until the next one.
+ *
+ * Queued messages are sent no later than CONFIG_MQTT_SAMPLE_PS_MAX_DELAY_MS after they were
+ * queued. The payload is copied, the topic must stay valid until the message is sent.
+ *
+ * @retval 0 if the message was sent or queued.
+ * @retval -ENOBUFS if the queue is full.
+ * @retval -EMSGSIZE if the payload is larger than CONFIG_MQTT_SAMPLE_PAYLOAD_SIZE.
+ */
+int mqtt_ps_sched_publish(struct mqtt_publish_param *param);
+
+/**
+ * @brief Report the connection state to the scheduler.
+ *
+ * Call with true on CONNACK and with false on disconnect. No heartbeats or deadline flushes are
+ * attempted while disconnected.
+ */
+void mqtt_ps_sched_connected_set(bool connected);
+
+/** @brief Enable or disable alignment to wake periods, for comparing wake counts. */
+void mqtt_ps_sched_align_set(bool enable);
+
+void mqtt_ps_sched_stats_get(struct mqtt_ps_sched_stats *stats);
+
+void mqtt_ps_sched_stats_log(void);
+
+#endif /* MQTT_PS_SCHED_H_ */
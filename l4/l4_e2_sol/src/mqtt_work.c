@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+
+#include "mqtt_work.h"
+
+static struct k_work_q work_q;
+static K_THREAD_STACK_DEFINE(work_q_stack, CONFIG_MQTT_SAMPLE_WORK_STACK_SIZE);
+
+int mqtt_work_init(void)
+{
+	struct k_work_queue_config cfg = {
+		.name = "mqtt_work",
+	};
+
+	k_work_queue_init(&work_q);
+	k_work_queue_start(&work_q, work_q_stack, K_THREAD_STACK_SIZEOF(work_q_stack),
+			   K_LOWEST_APPLICATION_THREAD_PRIO, &cfg);
+
+	return 0;
+}
+
+struct k_work_q *mqtt_work_q(void)
+{
+	return &work_q;
+}
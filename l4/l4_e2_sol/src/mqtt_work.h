@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef MQTT_WORK_H_
+#define MQTT_WORK_H_
+
+#include <zephyr/kernel.h>
+
+/**
+ * @brief Start the work queue of the sample.
+ *
+ * Work that calls into the MQTT helper, e.g. publishing or connecting, can block on the network
+ * for seconds and is submitted to this queue instead of the system work queue, which the DK
+ * buttons and the network stack depend on. Call before any other module is initialized.
+ */
+int mqtt_work_init(void);
+
+/** @brief Work queue of the sample, for k_work_submit_to_queue() and friends. */
+struct k_work_q *mqtt_work_q(void);
+
+#endif /* MQTT_WORK_H_ */
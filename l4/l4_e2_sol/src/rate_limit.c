@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "mqtt_work.h"
+#include "rate_limit.h"
+
+LOG_MODULE_REGISTER(rate_limit, LOG_LEVEL_INF);
+
+BUILD_ASSERT(CONFIG_MQTT_SAMPLE_RATE_CONTROL_RESERVE < CONFIG_MQTT_SAMPLE_RATE_UPLINK_BURST,
+	     "Telemetry could never be sent");
+
+/* Tokens are counted in thousandths so that a rate in tokens per second refills
+ * rate thousandths per millisecond.
+ */
+#define TOKEN 1000
+
+struct bucket {
+	uint32_t tokens;
+	uint32_t rate;
+	uint32_t burst;
+	int64_t last_refill;
+};
+
+struct topic_bucket {
+	const char *topic;
+	size_t topic_len;
+	struct bucket bucket;
+};
+
+struct queued_msg {
+	int64_t queued_at;
+	struct topic_bucket *topic_bucket;
+	struct mqtt_publish_param param;
+	uint8_t payload[CONFIG_MQTT_SAMPLE_PAYLOAD_SIZE];
+};
+
+K_MSGQ_DEFINE(control_queue, sizeof(struct queued_msg), CONFIG_MQTT_SAMPLE_RATE_CONTROL_QUEUE_SIZE,
+	      4);
+K_MSGQ_DEFINE(telemetry_queue, sizeof(struct queued_msg),
+	      CONFIG_MQTT_SAMPLE_RATE_TELEMETRY_QUEUE_SIZE, 4);
+
+static struct k_msgq *const queues[RATE_LANE_COUNT] = {
+	[RATE_LANE_CONTROL] = &control_queue,
+	[RATE_LANE_TELEMETRY] = &telemetry_queue,
+};
+
+static const uint32_t lane_rate[RATE_LANE_COUNT] = {
+	[RATE_LANE_CONTROL] = CONFIG_MQTT_SAMPLE_RATE_CONTROL_RATE,
+	[RATE_LANE_TELEMETRY] = CONFIG_MQTT_SAMPLE_RATE_TELEMETRY_RATE,
+};
+
+static const uint32_t lane_burst[RATE_LANE_COUNT] = {
+	[RATE_LANE_CONTROL] = CONFIG_MQTT_SAMPLE_RATE_CONTROL_BURST,
+	[RATE_LANE_TELEMETRY] = CONFIG_MQTT_SAMPLE_RATE_TELEMETRY_BURST,
+};
+
+static const char *const lane_name[RATE_LANE_COUNT] = {
+	[RATE_LANE_CONTROL] = "control",
+	[RATE_LANE_TELEMETRY] = "telemetry",
+};
+
+static struct topic_bucket topic_buckets[RATE_LANE_COUNT][CONFIG_MQTT_SAMPLE_RATE_TOPICS];
+static struct bucket uplink;
+static struct rate_limit_stats stats[RATE_LANE_COUNT];
+static rate_limit_send_t send_fn;
+
+static K_MUTEX_DEFINE(rate_lock);
+
+static void drain_work_fn(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(drain_work, drain_work_fn);
+
+static void bucket_refill(struct bucket *b, int64_t now)
+{
+	uint64_t tokens = b->tokens + (uint64_t)(now - b->last_refill) * b->rate;
+
+	b->tokens = MIN(tokens, (uint64_t)b->burst * TOKEN);
+	b->last_refill = now;
+}
+
+static void bucket_init(struct bucket *b, uint32_t rate, uint32_t burst)
+{
+	b->rate = rate;
+	b->burst = burst;
+	b->tokens = burst * TOKEN;
+	b->last_refill = k_uptime_get();
+}
+
+/* Milliseconds until the bucket holds reserve + 1 tokens. */
+static int64_t bucket_wait_ms(const struct bucket *b, uint32_t reserve)
+{
+	uint32_t needed = (reserve + 1) * TOKEN;
+
+	if (b->tokens >= needed) {
+		return 0;
+	}
+
+	return DIV_ROUND_UP(needed - b->tokens, MAX(b->rate, 1));
+}
+
+/* Must be called with rate_lock held. */
+static struct topic_bucket *topic_bucket_get(const struct mqtt_publish_param *param,
+					     enum rate_lane lane)
+{
+	const char *topic = param->message.topic.topic.utf8;
+	size_t len = param->message.topic.topic.size;
+	struct topic_bucket *free_slot = NULL;
+
+	for (size_t i = 0; i < ARRAY_SIZE(topic_buckets[lane]); i++) {
+		struct topic_bucket *tb = &topic_buckets[lane][i];
+
+		if (!tb->topic) {
+			free_slot = free_slot ? free_slot : tb;
+		} else if (tb->topic_len == len && memcmp(tb->topic, topic, len) == 0) {
+			return tb;
+		}
+	}
+
+	if (free_slot) {
+		free_slot->topic = topic;
+		free_slot->topic_len = len;
+		bucket_init(&free_slot->bucket, lane_rate[lane], lane_burst[lane]);
+	}
+
+	return free_slot;
+}
+
+/* Must be called with rate_lock held. Refills and reports the wait for a token. */
+static int64_t tokens_wait_ms(struct topic_bucket *tb, enum rate_lane lane, int64_t now)
+{
+	/* Telemetry leaves a few uplink tokens to control messages. */
+	uint32_t reserve = lane == RATE_LANE_TELEMETRY ? CONFIG_MQTT_SAMPLE_RATE_CONTROL_RESERVE : 0;
+
+	bucket_refill(&tb->bucket, now);
+	bucket_refill(&uplink, now);
+
+	return MAX(bucket_wait_ms(&tb->bucket, 0), bucket_wait_ms(&uplink, reserve));
+}
+
+/* Must be called with rate_lock held and tokens available. */
+static int send_now(struct topic_bucket *tb, enum rate_lane lane,
+		    struct mqtt_publish_param *param)
+{
+	int err;
+
+	tb->bucket.tokens -= TOKEN;
+	uplink.tokens -= TOKEN;
+
+	err = send_fn(param);
+	if (!err) {
+		stats[lane].sent++;
+	}
+
+	return err;
+}
+
+/* Must be called with rate_lock held. Returns the wait for the message at the head. */
+static int64_t lane_drain(enum rate_lane lane, int64_t now)
+{
+	int err;
+	int64_t wait;
+	struct queued_msg msg;
+
+	while (k_msgq_peek(queues[lane], &msg) == 0) {
+		wait = tokens_wait_ms(msg.topic_bucket, lane, now);
+		if (wait > 0) {
+			return wait;
+		}
+
+		(void)k_msgq_get(queues[lane], &msg, K_NO_WAIT);
+		msg.param.message.payload.data = msg.payload;
+		stats[lane].max_delay_ms = MAX(stats[lane].max_delay_ms,
+					       (uint32_t)(now - msg.queued_at));
+
+		err = send_now(msg.topic_bucket, lane, &msg.param);
+		if (err) {
+			LOG_WRN("Failed to send queued %s message, err: %d", lane_name[lane], err);
+		}
+	}
+
+	return -1;
+}
+
+/* Must be called with rate_lock held. Sends through send_fn, so drain_work runs on the MQTT work
+ * queue.
+ */
+static void drain(void)
+{
+	int64_t now = k_uptime_get();
+	int64_t next = INT64_MAX;
+	int64_t wait = lane_drain(RATE_LANE_CONTROL, now);
+
+	if (wait > 0) {
+		next = wait;
+	} else {
+		/* Telemetry only goes out once no control message is waiting. */
+		wait = lane_drain(RATE_LANE_TELEMETRY, now);
+		if (wait > 0) {
+			next = wait;
+		}
+	}
+
+	if (next != INT64_MAX) {
+		(void)k_work_reschedule_for_queue(mqtt_work_q(), &drain_work, K_MSEC(next));
+	}
+}
+
+static void drain_work_fn(struct k_work *work)
+{
+	k_mutex_lock(&rate_lock, K_FOREVER);
+	drain();
+	k_mutex_unlock(&rate_lock);
+}
+
+int rate_limit_init(rate_limit_send_t send)
+{
+	if (!send) {
+		return -EINVAL;
+	}
+
+	send_fn = send;
+	bucket_init(&uplink, CONFIG_MQTT_SAMPLE_RATE_UPLINK_RATE,
+		    CONFIG_MQTT_SAMPLE_RATE_UPLINK_BURST);
+
+	return 0;
+}
+
+int rate_limit_publish(struct mqtt_publish_param *param, enum rate_lane lane)
+{
+	int err;
+	struct queued_msg msg;
+	struct queued_msg oldest;
+	struct topic_bucket *tb;
+	int64_t now = k_uptime_get();
+
+	if (param->message.payload.len > sizeof(msg.payload)) {
+		return -EMSGSIZE;
+	}
+
+	k_mutex_lock(&rate_lock, K_FOREVER);
+
+	tb = topic_bucket_get(param, lane);
+	if (!tb) {
+		k_mutex_unlock(&rate_lock);
+		return -ENOMEM;
+	}
+
+	/* Queued messages of the lane keep their order, and telemetry yields to control. */
+	if (k_msgq_num_used_get(queues[lane]) == 0 &&
+	    (lane == RATE_LANE_CONTROL || k_msgq_num_used_get(&control_queue) == 0) &&
+	    tokens_wait_ms(tb, lane, now) == 0) {
+		err = send_now(tb, lane, param);
+		k_mutex_unlock(&rate_lock);
+		return err;
+	}
+
+	msg.queued_at = now;
+	msg.topic_bucket = tb;
+	msg.param = *param;
+	memcpy(msg.payload, param->message.payload.data, param->message.payload.len);
+
+	stats[lane].throttled++;
+
+	if (k_msgq_num_free_get(queues[lane]) == 0) {
+		if (lane == RATE_LANE_CONTROL) {
+			stats[lane].dropped++;
+			k_mutex_unlock(&rate_lock);
+			return -ENOBUFS;
+		}
+
+		/* Old telemetry is worth less than new telemetry. */
+		(void)k_msgq_get(queues[lane], &oldest, K_NO_WAIT);
+		stats[lane].dropped++;
+	}
+
+	(void)k_msgq_put(queues[lane], &msg, K_NO_WAIT);
+
+	drain();
+	k_mutex_unlock(&rate_lock);
+
+	return RATE_LIMIT_QUEUED;
+}
+
+void rate_limit_stats_get(enum rate_lane lane, struct rate_limit_stats *out)
+{
+	k_mutex_lock(&rate_lock, K_FOREVER);
+	*out = stats[lane];
+	k_mutex_unlock(&rate_lock);
+}
+
+void rate_limit_stats_log(void)
+{
+	struct rate_limit_stats s;
+
+	for (int lane = 0; lane < RATE_LANE_COUNT; lane++) {
+		rate_limit_stats_get(lane, &s);
+		LOG_INF("%s: sent %d, throttled %d, dropped %d, max delay %d ms", lane_name[lane],
+			s.sent, s.throttled, s.dropped, s.max_delay_ms);
+	}
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef RATE_LIMIT_H_
+#define RATE_LIMIT_H_
+
+#include <stdint.h>
+#include <net/mqtt_helper.h>
+
+/** @brief Priority lane of an outbound message. */
+enum rate_lane {
+	/* Button events, command acknowledgements and other messages that must not wait. */
+	RATE_LANE_CONTROL,
+	/* Periodic data that can be delayed or dropped under load. */
+	RATE_LANE_TELEMETRY,
+	RATE_LANE_COUNT,
+};
+
+/** @brief Returned by rate_limit_publish() when the message was queued instead of sent. */
+#define RATE_LIMIT_QUEUED 1
+
+/** @brief Function that puts a message on the wire. */
+typedef int (*rate_limit_send_t)(struct mqtt_publish_param *param);
+
+/** @brief Counters kept for each lane. */
+struct rate_limit_stats {
+	uint32_t sent;
+	/* Messages that were queued because a bucket was empty. */
+	uint32_t throttled;
+	/* Messages dropped because the lane queue was full. */
+	uint32_t dropped;
+	uint32_t max_delay_ms;
+};
+
+/**
+ * @brief Initialize the rate limiter.
+ *
+ * @param send Function that publishes a message immediately.
+ */
+int rate_limit_init(rate_limit_send_t send);
+
+/**
+ * @brief Publish a message through the token buckets.
+ *
+ * The message is sent at once if the bucket of its topic and the uplink bucket both have a
+ * token, otherwise it is queued in its lane. Control messages are always sent before queued
+ * telemetry, and telemetry may not use the last CONFIG_MQTT_SAMPLE_RATE_CONTROL_RESERVE uplink
+ * tokens. When the telemetry queue is full the oldest message is dropped. The payload is
+ * copied, the topic must stay valid until the message is sent.
+ *
+ * @retval 0 if the message was sent.
+ * @retval RATE_LIMIT_QUEUED if the message was queued and is sent from the MQTT work queue once
+ *         tokens are available.
+ * @retval -ENOBUFS if the control queue is full.
+ * @retval -ENOMEM if no bucket is free for a new topic.
+ * @retval -EMSGSIZE if the payload is larger than CONFIG_MQTT_SAMPLE_PAYLOAD_SIZE.
+ */
+int rate_limit_publish(struct mqtt_publish_param *param, enum rate_lane lane);
+
+void rate_limit_stats_get(enum rate_lane lane, struct rate_limit_stats *stats);
+
+void rate_limit_stats_log(void);
+
+#endif /* RATE_LIMIT_H_ */
@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/random/random.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/mqtt_sn.h>
+
+#include "sn_client.h"
+
+LOG_MODULE_REGISTER(sn_client, LOG_LEVEL_INF);
+
+#define PUB_TOPIC CONFIG_MQTT_SAMPLE_PUB_TOPIC
+#define SUB_TOPIC CONFIG_MQTT_SAMPLE_SUB_TOPIC
+#define GATEWAY_ID 1
+
+/* MQTT-SN PUBLISH header: length, type, flags, topic ID and message ID. */
+#define SN_PUBLISH_HEADER_SIZE 7
+
+#if CONFIG_MQTT_SAMPLE_SN_QOS == -1
+#define SN_QOS MQTT_SN_QOS_M1
+#elif CONFIG_MQTT_SAMPLE_SN_QOS == 1
+#define SN_QOS MQTT_SN_QOS_1
+#else
+#define SN_QOS MQTT_SN_QOS_0
+#endif
+
+static struct mqtt_sn_client client;
+static struct mqtt_sn_transport_udp transport;
+static struct sockaddr_in gateway;
+static uint8_t tx_buf[CONFIG_MQTT_SAMPLE_SN_BUFFER_SIZE];
+static uint8_t rx_buf[CONFIG_MQTT_SAMPLE_SN_BUFFER_SIZE];
+static sn_client_publish_cb_t publish_cb;
+static bool connected;
+static bool asleep;
+static int64_t connect_start;
+static int64_t last_activity;
+
+static K_MUTEX_DEFINE(client_lock);
+static K_SEM_DEFINE(connected_sem, 0, 1);
+
+static char client_id[sizeof(CONFIG_BOARD) + 11];
+
+/* Size of the equivalent MQTT 3.1.1 PUBLISH, for comparing bytes per message. */
+static size_t mqtt_publish_size(size_t topic_len, size_t payload_len, bool qos)
+{
+	size_t remaining = 2 + topic_len + (qos ? 2 : 0) + payload_len;
+
+	return 1 + (remaining < 128 ? 1 : remaining < 16384 ? 2 : 3) + remaining;
+}
+
+static void evt_cb(struct mqtt_sn_client *c, const struct mqtt_sn_evt *evt)
+{
+	switch (evt->type) {
+	case MQTT_SN_EVT_CONNECTED:
+		LOG_INF("MQTT-SN connected in %lld ms", k_uptime_get() - connect_start);
+		connected = true;
+		asleep = false;
+		k_sem_give(&connected_sem);
+		break;
+	case MQTT_SN_EVT_DISCONNECTED:
+		LOG_INF("MQTT-SN disconnected");
+		connected = false;
+		break;
+	case MQTT_SN_EVT_ASLEEP:
+		LOG_INF("MQTT-SN client asleep");
+		asleep = true;
+		break;
+	case MQTT_SN_EVT_AWAKE:
+		LOG_DBG("MQTT-SN client awake, fetching buffered messages");
+		break;
+	case MQTT_SN_EVT_PUBLISH: {
+		/* Only SUB_TOPIC is subscribed to, so every message belongs to it. */
+		struct mqtt_helper_buf topic = {
+			.ptr = SUB_TOPIC,
+			.size = sizeof(SUB_TOPIC) - 1,
+		};
+		struct mqtt_helper_buf payload = {
+			.ptr = (char *)evt->param.publish.data.data,
+			.size = evt->param.publish.data.size,
+		};
+
+		if (publish_cb) {
+			publish_cb(topic, payload);
+		}
+		break;
+	}
+	case MQTT_SN_EVT_PINGRESP:
+		LOG_DBG("MQTT-SN PINGRESP");
+		break;
+	default:
+		break;
+	}
+}
+
+static void input_thread(void)
+{
+	int err;
+
+	while (true) {
+		k_mutex_lock(&client_lock, K_FOREVER);
+
+		err = mqtt_sn_input(&client);
+		if (err < 0) {
+			LOG_DBG("mqtt_sn_input failed, err: %d", err);
+		}
+
+		if (CONFIG_MQTT_SAMPLE_SN_SLEEP_S > 0 && connected && !asleep &&
+		    k_uptime_get() - last_activity > CONFIG_MQTT_SAMPLE_SN_IDLE_MS) {
+			err = mqtt_sn_sleep(&client, CONFIG_MQTT_SAMPLE_SN_SLEEP_S);
+			if (err) {
+				LOG_WRN("Failed to go to sleep, err: %d", err);
+			}
+		}
+
+		k_mutex_unlock(&client_lock);
+		k_sleep(K_MSEC(CONFIG_MQTT_SAMPLE_SN_POLL_MS));
+	}
+}
+
+K_THREAD_DEFINE(sn_client_thread, CONFIG_MQTT_SAMPLE_SN_STACK_SIZE, input_thread, NULL, NULL,
+		NULL, K_LOWEST_APPLICATION_THREAD_PRIO, 0, K_TICKS_FOREVER);
+
+int sn_client_init(sn_client_publish_cb_t on_publish)
+{
+	int err;
+	struct mqtt_sn_data id;
+	struct mqtt_sn_data gw_addr;
+	struct mqtt_sn_data pub_topic = MQTT_SN_DATA_STRING_LITERAL(PUB_TOPIC);
+
+	publish_cb = on_publish;
+
+	gateway.sin_family = AF_INET;
+	gateway.sin_port = htons(CONFIG_MQTT_SAMPLE_SN_GATEWAY_PORT);
+	err = zsock_inet_pton(AF_INET, CONFIG_MQTT_SAMPLE_SN_GATEWAY_ADDR, &gateway.sin_addr);
+	if (err != 1) {
+		LOG_ERR("Invalid gateway address: %s", CONFIG_MQTT_SAMPLE_SN_GATEWAY_ADDR);
+		return -EINVAL;
+	}
+
+	err = mqtt_sn_transport_udp_init(&transport, (struct sockaddr *)&gateway,
+					 sizeof(gateway));
+	if (err) {
+		LOG_ERR("Failed to initialize UDP transport, err: %d", err);
+		return err;
+	}
+
+	snprintf(client_id, sizeof(client_id), "%s-%010u", CONFIG_BOARD, sys_rand32_get());
+	id.data = (const uint8_t *)client_id;
+	id.size = strlen(client_id);
+
+	err = mqtt_sn_client_init(&client, &id, &transport.tp, evt_cb, tx_buf, sizeof(tx_buf),
+				  rx_buf, sizeof(rx_buf));
+	if (err) {
+		LOG_ERR("Failed to initialize MQTT-SN client, err: %d", err);
+		return err;
+	}
+
+	gw_addr.data = (uint8_t *)&gateway;
+	gw_addr.size = sizeof(gateway);
+	err = mqtt_sn_add_gw(&client, GATEWAY_ID, gw_addr);
+	if (err) {
+		LOG_ERR("Failed to add gateway, err: %d", err);
+		return err;
+	}
+
+	/* QoS -1 can only use a topic ID agreed on beforehand with the gateway. */
+	if (CONFIG_MQTT_SAMPLE_SN_QOS == -1) {
+		err = mqtt_sn_predefine_topic(&client, CONFIG_MQTT_SAMPLE_SN_PREDEFINED_TOPIC_ID,
+					      &pub_topic);
+		if (err) {
+			LOG_ERR("Failed to predefine topic, err: %d", err);
+			return err;
+		}
+	}
+
+	k_thread_start(sn_client_thread);
+
+	LOG_INF("MQTT-SN client ID: %s", client_id);
+	LOG_INF("Gateway: %s:%d", CONFIG_MQTT_SAMPLE_SN_GATEWAY_ADDR,
+		CONFIG_MQTT_SAMPLE_SN_GATEWAY_PORT);
+	return 0;
+}
+
+/* Must be called with client_lock held. */
+static int connect_locked(void)
+{
+	int err;
+
+	k_sem_reset(&connected_sem);
+	connect_start = k_uptime_get();
+	last_activity = connect_start;
+
+	err = mqtt_sn_connect(&client, false, true);
+	if (err) {
+		LOG_ERR("Failed to send MQTT-SN CONNECT, err: %d", err);
+	}
+
+	return err;
+}
+
+int sn_client_connect(void)
+{
+	int err;
+	struct mqtt_sn_data sub_topic = MQTT_SN_DATA_STRING_LITERAL(SUB_TOPIC);
+
+	/* QoS -1 publishes to a predefined topic without ever connecting to the gateway */
+	if (SN_QOS == MQTT_SN_QOS_M1) {
+		return 0;
+	}
+
+	k_mutex_lock(&client_lock, K_FOREVER);
+	err = connect_locked();
+	k_mutex_unlock(&client_lock);
+	if (err) {
+		return err;
+	}
+
+	err = k_sem_take(&connected_sem, K_MSEC(CONFIG_MQTT_SAMPLE_SN_CONNECT_TIMEOUT_MS));
+	if (err) {
+		LOG_ERR("No CONNACK from the gateway");
+		return -ETIMEDOUT;
+	}
+
+	k_mutex_lock(&client_lock, K_FOREVER);
+	err = mqtt_sn_subscribe(&client, MQTT_SN_QOS_1, &sub_topic);
+	k_mutex_unlock(&client_lock);
+	if (err) {
+		LOG_ERR("Failed to subscribe to %s, err: %d", SUB_TOPIC, err);
+		return err;
+	}
+
+	LOG_INF("Subscribing to %s", SUB_TOPIC);
+	return 0;
+}
+
+int sn_client_publish(const uint8_t *data, size_t len)
+{
+	int err;
+	struct mqtt_sn_data topic = MQTT_SN_DATA_STRING_LITERAL(PUB_TOPIC);
+	struct mqtt_sn_data payload = {
+		.data = data,
+		.size = len,
+	};
+
+	k_mutex_lock(&client_lock, K_FOREVER);
+
+	if (SN_QOS != MQTT_SN_QOS_M1 && asleep) {
+		/* A CONNECT takes a sleeping client back to the active state. The lock is released
+		 * while waiting, the input thread needs it to process the CONNACK.
+		 */
+		err = connect_locked();
+		k_mutex_unlock(&client_lock);
+		if (err) {
+			return err;
+		}
+
+		err = k_sem_take(&connected_sem, K_MSEC(CONFIG_MQTT_SAMPLE_SN_CONNECT_TIMEOUT_MS));
+		if (err) {
+			LOG_ERR("No CONNACK from the gateway");
+			return -ETIMEDOUT;
+		}
+
+		k_mutex_lock(&client_lock, K_FOREVER);
+	}
+
+	err = mqtt_sn_publish(&client, SN_QOS, &topic, false, &payload);
+	last_activity = k_uptime_get();
+
+	k_mutex_unlock(&client_lock);
+
+	if (err) {
+		return err;
+	}
+
+	LOG_INF("MQTT-SN PUBLISH: %d bytes, equivalent MQTT PUBLISH: %d bytes",
+		SN_PUBLISH_HEADER_SIZE + len,
+		mqtt_publish_size(sizeof(PUB_TOPIC) - 1, len, SN_QOS == MQTT_SN_QOS_1));
+	return 0;
+}
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef SN_CLIENT_H_
+#define SN_CLIENT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <net/mqtt_helper.h>
+
+/** @brief Handler for messages received on the subscribed topic. */
+typedef void (*sn_client_publish_cb_t)(struct mqtt_helper_buf topic,
+				       struct mqtt_helper_buf payload);
+
+/**
+ * @brief Initialize the MQTT-SN client and its UDP transport.
+ *
+ * @param on_publish Called for every message received on CONFIG_MQTT_SAMPLE_SUB_TOPIC.
+ */
+int sn_client_init(sn_client_publish_cb_t on_publish);
+
+/**
+ * @brief Connect to the gateway and subscribe to CONFIG_MQTT_SAMPLE_SUB_TOPIC.
+ *
+ * Returns 0 right away for QoS -1, which publishes to a predefined topic without a connection.
+ */
+int sn_client_connect(void);
+
+/**
+ * @brief Publish to CONFIG_MQTT_SAMPLE_PUB_TOPIC with CONFIG_MQTT_SAMPLE_SN_QOS.
+ *
+ * A sleeping client is woken up before publishing.
+ */
+int sn_client_publish(const uint8_t *data, size_t len);
+
+#endif /* SN_CLIENT_H_ */
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zcbor_common.h>
+#include <zcbor_decode.h>
+#include <zcbor_encode.h>
+
+#include "telemetry_cbor.h"
+
+enum telemetry_key {
+	TELEMETRY_KEY_SEQ = 1,
+	TELEMETRY_KEY_UPTIME = 2,
+	TELEMETRY_KEY_BUTTON = 3,
+	TELEMETRY_KEY_SAMPLES = 4,
+};
+
+enum led_command_key {
+	LED_COMMAND_KEY_LED = 1,
+	LED_COMMAND_KEY_ON = 2,
+};
+
+#define TELEMETRY_MAP_ENTRIES 4
+#define LED_COMMAND_MAP_ENTRIES 2
+
+static bool samples_encode(zcbor_state_t *state, const struct telemetry_msg *msg)
+{
+	bool ok = zcbor_uint32_put(state, TELEMETRY_KEY_SAMPLES) &&
+		  zcbor_list_start_encode(state, TELEMETRY_MAX_SAMPLES);
+
+	for (size_t i = 0; ok && i < msg->sample_count; i++) {
+		ok = zcbor_int32_put(state, msg->samples[i]);
+	}
+
+	return ok && zcbor_list_end_encode(state, TELEMETRY_MAX_SAMPLES);
+}
+
+int telemetry_cbor_encode(const struct telemetry_msg *msg, uint8_t *buf, size_t len,
+			  size_t *out_len)
+{
+	bool ok;
+
+	/* One backup each for the map and the nested sample list. */
+	ZCBOR_STATE_E(state, 2, buf, len, 1);
+
+	if (msg->sample_count > TELEMETRY_MAX_SAMPLES) {
+		return -EINVAL;
+	}
+
+	ok = zcbor_map_start_encode(state, TELEMETRY_MAP_ENTRIES) &&
+	     zcbor_uint32_put(state, TELEMETRY_KEY_SEQ) &&
+	     zcbor_uint32_put(state, msg->seq) &&
+	     zcbor_uint32_put(state, TELEMETRY_KEY_UPTIME) &&
+	     zcbor_uint32_put(state, msg->uptime_ms);
+
+	if (ok && msg->button != 0) {
+		ok = zcbor_uint32_put(state, TELEMETRY_KEY_BUTTON) &&
+		     zcbor_uint32_put(state, msg->button);
+	}
+
+	if (ok && msg->sample_count > 0) {
+		ok = samples_encode(state, msg);
+	}
+
+	ok = ok && zcbor_map_end_encode(state, TELEMETRY_MAP_ENTRIES);
+	if (!ok) {
+		return -ENOMEM;
+	}
+
+	*out_len = state->payload - buf;
+	return 0;
+}
+
+int led_command_cbor_decode(const uint8_t *buf, size_t len, struct led_command *cmd)
+{
+	uint32_t key;
+	bool has_led = false;
+	bool has_on = false;
+	bool ok;
+
+	ZCBOR_STATE_D(state, 1, buf, len, 1, 0);
+
+	ok = zcbor_map_start_decode(state);
+
+	while (ok && !zcbor_array_at_end(state)) {
+		ok = zcbor_uint32_decode(state, &key);
+		if (!ok) {
+			break;
+		}
+
+		switch (key) {
+		case LED_COMMAND_KEY_LED:
+			ok = zcbor_uint32_decode(state, &cmd->led);
+			has_led = ok;
+			break;
+		case LED_COMMAND_KEY_ON:
+			ok = zcbor_bool_decode(state, &cmd->on);
+			has_on = ok;
+			break;
+		default:
+			/* Unknown keys are skipped so the schema can be extended. */
+			ok = zcbor_any_skip(state, NULL);
+			break;
+		}
+	}
+
+	ok = ok && zcbor_map_end_decode(state);
+	if (!ok || !has_led || !has_on) {
+		return -EBADMSG;
+	}
+
+	return 0;
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef TELEMETRY_CBOR_H_
+#define TELEMETRY_CBOR_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(CONFIG_MQTT_SAMPLE_CBOR)
+#define TELEMETRY_MAX_SAMPLES CONFIG_MQTT_SAMPLE_CBOR_MAX_SAMPLES
+#else
+/* Keeps the declarations below valid when CBOR is disabled and nothing is encoded. */
+#define TELEMETRY_MAX_SAMPLES 1
+#endif
+
+/* Worst case size of an encoded telemetry message: map header, three keyed uint32 values and a
+ * keyed array header followed by int32 samples of up to five bytes each.
+ */
+#define TELEMETRY_CBOR_MAX_SIZE (1 + 3 * (1 + 5) + (1 + 3) + TELEMETRY_MAX_SAMPLES * 5)
+
+/** @brief Telemetry message, see the telemetry rule in telemetry.cddl. */
+struct telemetry_msg {
+	uint32_t seq;
+	uint32_t uptime_ms;
+	/* 0 when the message is not a button event. */
+	uint8_t button;
+	size_t sample_count;
+	int32_t samples[TELEMETRY_MAX_SAMPLES];
+};
+
+/** @brief LED command, see the led_command rule in telemetry.cddl. */
+struct led_command {
+	uint32_t led;
+	bool on;
+};
+
+/**
+ * @brief Encode a telemetry message.
+ *
+ * @param msg     Message to encode.
+ * @param buf     Output buffer, TELEMETRY_CBOR_MAX_SIZE bytes is always enough.
+ * @param len     Size of @p buf.
+ * @param out_len Number of bytes written.
+ *
+ * @retval 0 on success.
+ * @retval -ENOMEM if @p buf is too small.
+ */
+int telemetry_cbor_encode(const struct telemetry_msg *msg, uint8_t *buf, size_t len,
+			  size_t *out_len);
+
+/**
+ * @brief Decode an LED command.
+ *
+ * @retval 0 on success.
+ * @retval -EBADMSG if the payload is not a valid LED command.
+ */
+int led_command_cbor_decode(const uint8_t *buf, size_t len, struct led_command *cmd);
+
+#endif /* TELEMETRY_CBOR_H_ */
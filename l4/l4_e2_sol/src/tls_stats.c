@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <mbedtls/memory_buffer_alloc.h>
+
+#include "tls_stats.h"
+
+LOG_MODULE_REGISTER(tls_stats, LOG_LEVEL_INF);
+
+static int64_t connect_start;
+static int64_t handshake_ms;
+
+void tls_stats_connect_start(void)
+{
+	mbedtls_memory_buffer_alloc_max_reset();
+	connect_start = k_uptime_get();
+}
+
+void tls_stats_connect_done(void)
+{
+	handshake_ms = k_uptime_get() - connect_start;
+}
+
+void tls_stats_log(void)
+{
+	size_t cur_used, cur_blocks;
+	size_t max_used, max_blocks;
+
+	mbedtls_memory_buffer_alloc_cur_get(&cur_used, &cur_blocks);
+	mbedtls_memory_buffer_alloc_max_get(&max_used, &max_blocks);
+
+	LOG_INF("DNS, TCP and TLS handshake: %lld ms, CONNACK after %lld ms", handshake_ms,
+		k_uptime_get() - connect_start);
+	LOG_INF("mbedTLS heap: peak %d bytes in %d blocks, %d bytes held by the session, "
+		"%d bytes configured", max_used, max_blocks, cur_used, CONFIG_MBEDTLS_HEAP_SIZE);
+	LOG_INF("TLS records: %d bytes in, %d bytes out", CONFIG_MBEDTLS_SSL_IN_CONTENT_LEN,
+		CONFIG_MBEDTLS_SSL_OUT_CONTENT_LEN);
+}
@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef TLS_STATS_H_
+#define TLS_STATS_H_
+
+/** @brief Call right before mqtt_helper_connect(). Resets the peak heap counter. */
+void tls_stats_connect_start(void);
+
+/**
+ * @brief Call when mqtt_helper_connect() returns.
+ *
+ * The helper resolves the broker, opens the TCP connection and runs the TLS handshake before
+ * returning, so this marks the end of the handshake.
+ */
+void tls_stats_connect_done(void);
+
+/** @brief Log handshake time, CONNACK time and peak mbedTLS heap use. Call on CONNACK. */
+void tls_stats_log(void);
+
+#endif /* TLS_STATS_H_ */
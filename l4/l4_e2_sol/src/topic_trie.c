@@ -0,0 +1,343 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "topic_trie.h"
+
+LOG_MODULE_REGISTER(topic_trie, LOG_LEVEL_INF);
+
+#define ROOT 0
+#define NONE -1
+
+/* FNV-1a over the parent index and the level */
+static uint32_t level_hash(int16_t parent, const char *level, size_t len)
+{
+	uint32_t hash = (2166136261U ^ (uint16_t)parent) * 16777619U;
+
+	for (size_t i = 0; i < len; i++) {
+		hash = (hash ^ (uint8_t)level[i]) * 16777619U;
+	}
+
+	return hash;
+}
+
+/* Bucket holding the literal child, or the free bucket it goes in. The table is never full. */
+static int16_t *bucket_find(const struct topic_trie *trie, int16_t parent, const char *level,
+			    size_t len)
+{
+	uint16_t b = level_hash(parent, level, len) % trie->bucket_count;
+
+	while (trie->buckets[b] != 0) {
+		const struct topic_trie_node *node = &trie->nodes[trie->buckets[b]];
+
+		if (node->parent == parent && node->level_len == len &&
+		    memcmp(node->level, level, len) == 0) {
+			break;
+		}
+
+		b = (b + 1) % trie->bucket_count;
+	}
+
+	return &trie->buckets[b];
+}
+
+static int16_t *wildcard_find(const struct topic_trie *trie, int16_t parent, const char *level,
+			      size_t len)
+{
+	if (len == 1 && level[0] == '+') {
+		return &trie->nodes[parent].plus;
+	} else if (len == 1 && level[0] == '#') {
+		return &trie->nodes[parent].hash;
+	}
+
+	return NULL;
+}
+
+static int16_t child_find(const struct topic_trie *trie, int16_t parent, const char *level,
+			  size_t len)
+{
+	int16_t *wildcard = wildcard_find(trie, parent, level, len);
+	int16_t i = wildcard ? *wildcard : *bucket_find(trie, parent, level, len);
+
+	return i == 0 ? NONE : i;
+}
+
+static int16_t child_add(struct topic_trie *trie, int16_t parent, const char *level, size_t len)
+{
+	int16_t i;
+	int16_t *wildcard;
+
+	if (trie->count >= trie->capacity) {
+		return NONE;
+	}
+
+	i = trie->count++;
+	trie->nodes[i] = (struct topic_trie_node) {
+		.level = level,
+		.level_len = len,
+		.parent = parent,
+		.plus = NONE,
+		.hash = NONE,
+	};
+
+	wildcard = wildcard_find(trie, parent, level, len);
+	if (wildcard) {
+		*wildcard = i;
+	} else {
+		*bucket_find(trie, parent, level, len) = i;
+	}
+
+	return i;
+}
+
+int topic_trie_add(struct topic_trie *trie, const char *filter, topic_trie_handler_t handler,
+		   void *user_data)
+{
+	int16_t node = ROOT;
+	const char *level = filter;
+	size_t filter_len = strlen(filter);
+
+	if (filter_len == 0 || !handler) {
+		return -EINVAL;
+	}
+
+	while (true) {
+		const char *end = memchr(level, '/', filter + filter_len - level);
+		size_t len = end ? (size_t)(end - level) : (size_t)(filter + filter_len - level);
+		int16_t next;
+
+		/* Wildcards must take a whole level, and # must be the last one. */
+		if ((memchr(level, '+', len) && len != 1) || (memchr(level, '#', len) &&
+		    (len != 1 || end))) {
+			return -EINVAL;
+		}
+
+		next = child_find(trie, node, level, len);
+		if (next == NONE) {
+			next = child_add(trie, node, level, len);
+			if (next == NONE) {
+				return -ENOMEM;
+			}
+		}
+
+		node = next;
+
+		if (!end) {
+			break;
+		}
+		level = end + 1;
+	}
+
+	if (trie->nodes[node].handler) {
+		return -EALREADY;
+	}
+
+	trie->nodes[node].handler = handler;
+	trie->nodes[node].user_data = user_data;
+
+	return 0;
+}
+
+static int call(const struct topic_trie_node *node, struct mqtt_helper_buf topic,
+		struct mqtt_helper_buf payload)
+{
+	if (!node->handler) {
+		return 0;
+	}
+
+	node->handler(topic, payload, node->user_data);
+	return 1;
+}
+
+/* pos is the start of the next topic level, or past the end once every level has matched. */
+static int match(const struct topic_trie *trie, int16_t node, struct mqtt_helper_buf topic,
+		 struct mqtt_helper_buf payload, size_t pos)
+{
+	int calls = 0;
+	const struct topic_trie_node *parent = &trie->nodes[node];
+	const char *level;
+	const char *end;
+	size_t len;
+	int16_t i;
+
+	if (pos > topic.size) {
+		calls += call(parent, topic, payload);
+
+		/* "a/#" also matches "a" */
+		if (parent->hash != NONE) {
+			calls += call(&trie->nodes[parent->hash], topic, payload);
+		}
+
+		return calls;
+	}
+
+	level = topic.ptr + pos;
+	end = memchr(level, '/', topic.size - pos);
+	len = end ? (size_t)(end - level) : topic.size - pos;
+
+	/* Wildcards at the first level do not match topics starting with $ */
+	if (node != ROOT || len == 0 || level[0] != '$') {
+		if (parent->hash != NONE) {
+			calls += call(&trie->nodes[parent->hash], topic, payload);
+		}
+
+		if (parent->plus != NONE) {
+			calls += match(trie, parent->plus, topic, payload, pos + len + 1);
+		}
+	}
+
+	i = *bucket_find(trie, node, level, len);
+	if (i != 0) {
+		calls += match(trie, i, topic, payload, pos + len + 1);
+	}
+
+	return calls;
+}
+
+int topic_trie_dispatch(const struct topic_trie *trie, struct mqtt_helper_buf topic,
+			struct mqtt_helper_buf payload)
+{
+	return match(trie, ROOT, topic, payload, 0);
+}
+
+bool topic_filter_matches(const char *filter, const char *topic, size_t topic_len)
+{
+	size_t pos = 0;
+	bool levels_left = true;
+
+	if (topic_len > 0 && topic[0] == '$' && (filter[0] == '+' || filter[0] == '#')) {
+		return false;
+	}
+
+	while (true) {
+		const char *filter_end = strchr(filter, '/');
+		size_t filter_len = filter_end ? (size_t)(filter_end - filter) : strlen(filter);
+		const char *level_end;
+		size_t level_len;
+
+		if (filter_len == 1 && filter[0] == '#') {
+			return true;
+		}
+
+		if (!levels_left) {
+			return false;
+		}
+
+		level_end = memchr(topic + pos, '/', topic_len - pos);
+		level_len = level_end ? (size_t)(level_end - (topic + pos)) : topic_len - pos;
+
+		if (!(filter_len == 1 && filter[0] == '+') &&
+		    (filter_len != level_len || memcmp(filter, topic + pos, level_len) != 0)) {
+			return false;
+		}
+
+		levels_left = level_end != NULL;
+		pos += level_len + 1;
+
+		if (!filter_end) {
+			return !levels_left;
+		}
+
+		filter = filter_end + 1;
+	}
+}
+
+#if defined(CONFIG_MQTT_SAMPLE_TOPIC_TRIE_BENCH)
+
+#define BENCH_DEVICES CONFIG_MQTT_SAMPLE_TOPIC_TRIE_BENCH_DEVICES
+#define BENCH_ITERATIONS CONFIG_MQTT_SAMPLE_TOPIC_TRIE_BENCH_ITERATIONS
+#define BENCH_FILTER_LEN 32
+
+/* Two filters per device, "bench/devN/+/temp" and "bench/devN/#". */
+#define BENCH_FILTERS (2 * BENCH_DEVICES)
+/* Topics "bench/devN/roomM/temp", built before timing so only matching is measured. */
+#define BENCH_ROOMS 4
+
+/* The root and "bench", then "devN", "+", "temp" and "#" for every device. */
+TOPIC_TRIE_DEFINE(bench_trie, 2 + 4 * BENCH_DEVICES);
+static char bench_filters[BENCH_FILTERS][BENCH_FILTER_LEN];
+static struct mqtt_helper_buf bench_topics[BENCH_DEVICES][BENCH_ROOMS];
+static char bench_topic_bufs[BENCH_DEVICES][BENCH_ROOMS][BENCH_FILTER_LEN];
+static uint32_t bench_calls;
+
+static void bench_handler(struct mqtt_helper_buf topic, struct mqtt_helper_buf payload,
+			  void *user_data)
+{
+	bench_calls++;
+}
+
+void topic_trie_bench_run(void)
+{
+	int err;
+	struct mqtt_helper_buf payload = { 0 };
+	uint32_t start;
+	uint64_t trie_ns, linear_ns;
+	uint32_t trie_calls, linear_calls;
+
+	for (size_t i = 0; i < BENCH_DEVICES; i++) {
+		snprintf(bench_filters[2 * i], BENCH_FILTER_LEN, "bench/dev%d/+/temp", i);
+		snprintf(bench_filters[2 * i + 1], BENCH_FILTER_LEN, "bench/dev%d/#", i);
+
+		for (size_t j = 0; j < BENCH_ROOMS; j++) {
+			bench_topics[i][j].ptr = bench_topic_bufs[i][j];
+			bench_topics[i][j].size = snprintf(bench_topic_bufs[i][j], BENCH_FILTER_LEN,
+							   "bench/dev%d/room%d/temp", i, j);
+		}
+	}
+
+	for (size_t i = 0; i < BENCH_FILTERS; i++) {
+		err = topic_trie_add(&bench_trie, bench_filters[i], bench_handler, NULL);
+		if (err) {
+			LOG_ERR("Failed to add %s, err: %d", bench_filters[i], err);
+			return;
+		}
+	}
+
+	/* Every topic matches two filters, one through each wildcard. */
+	bench_calls = 0;
+	start = k_cycle_get_32();
+
+	for (size_t i = 0; i < BENCH_ITERATIONS; i++) {
+		(void)topic_trie_dispatch(&bench_trie, bench_topics[i % BENCH_DEVICES][i % BENCH_ROOMS],
+					  payload);
+	}
+
+	trie_ns = k_cyc_to_ns_floor64(k_cycle_get_32() - start);
+	trie_calls = bench_calls;
+
+	bench_calls = 0;
+	start = k_cycle_get_32();
+
+	for (size_t i = 0; i < BENCH_ITERATIONS; i++) {
+		struct mqtt_helper_buf topic = bench_topics[i % BENCH_DEVICES][i % BENCH_ROOMS];
+
+		for (size_t j = 0; j < BENCH_FILTERS; j++) {
+			if (topic_filter_matches(bench_filters[j], topic.ptr, topic.size)) {
+				bench_handler(topic, payload, NULL);
+			}
+		}
+	}
+
+	linear_ns = k_cyc_to_ns_floor64(k_cycle_get_32() - start);
+	linear_calls = bench_calls;
+
+	if (trie_calls != linear_calls) {
+		LOG_ERR("Trie and linear scan disagree: %d vs %d matches", trie_calls,
+			linear_calls);
+	}
+
+	LOG_INF("%d filters, %d trie nodes, %d topics", BENCH_FILTERS, bench_trie.count,
+		BENCH_ITERATIONS);
+	LOG_INF("Trie: %d ns/topic, linear scan: %d ns/topic",
+		(uint32_t)(trie_ns / BENCH_ITERATIONS), (uint32_t)(linear_ns / BENCH_ITERATIONS));
+}
+
+#endif /* CONFIG_MQTT_SAMPLE_TOPIC_TRIE_BENCH */
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef TOPIC_TRIE_H_
+#define TOPIC_TRIE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <net/mqtt_helper.h>
+
+/** @brief Handler called for every message whose topic matches the registered filter. */
+typedef void (*topic_trie_handler_t)(struct mqtt_helper_buf topic,
+				     struct mqtt_helper_buf payload, void *user_data);
+
+/** @brief One topic level in the trie. */
+struct topic_trie_node {
+	const char *level;
+	uint16_t level_len;
+	int16_t parent;
+	/* Wildcard children, literal children are found through the buckets of the trie. */
+	int16_t plus;
+	int16_t hash;
+	topic_trie_handler_t handler;
+	void *user_data;
+};
+
+/** @brief Topic trie backed by a fixed array of nodes. */
+struct topic_trie {
+	struct topic_trie_node *nodes;
+	/* Literal children hashed by parent and level, with linear probing. 0 marks a free bucket,
+	 * the root is never a child.
+	 */
+	int16_t *buckets;
+	uint16_t capacity;
+	uint16_t bucket_count;
+	uint16_t count;
+};
+
+/**
+ * @brief Statically define a topic trie.
+ *
+ * Twice as many buckets as nodes keep the hash table at most half full.
+ *
+ * @param _name      Name of the trie.
+ * @param _max_nodes Maximum number of distinct topic levels over all filters, plus one.
+ */
+#define TOPIC_TRIE_DEFINE(_name, _max_nodes)						\
+	static struct topic_trie_node _name##_nodes[_max_nodes] = {			\
+		[0] = { .parent = -1, .plus = -1, .hash = -1 },				\
+	};										\
+	static int16_t _name##_buckets[2 * (_max_nodes)];				\
+	static struct topic_trie _name = {						\
+		.nodes = _name##_nodes,							\
+		.buckets = _name##_buckets,						\
+		.capacity = _max_nodes,							\
+		.bucket_count = 2 * (_max_nodes),					\
+		.count = 1,								\
+	}
+
+/**
+ * @brief Add a topic filter to the trie.
+ *
+ * Filters may contain the single-level wildcard + and, as their last level, the multi-level
+ * wildcard #. The filter string is not copied and must stay valid.
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if the filter is malformed.
+ * @retval -ENOMEM if the trie has no free nodes.
+ * @retval -EALREADY if a handler is already registered for the filter.
+ */
+int topic_trie_add(struct topic_trie *trie, const char *filter, topic_trie_handler_t handler,
+		   void *user_data);
+
+/**
+ * @brief Call the handler of every filter matching the topic.
+ *
+ * Walks the trie one topic level at a time with one hash lookup per level, so the cost grows
+ * with the topic depth and the number of wildcard branches rather than with the number of
+ * filters or the number of children of a level. Nothing is allocated.
+ *
+ * @return Number of handlers called.
+ */
+int topic_trie_dispatch(const struct topic_trie *trie, struct mqtt_helper_buf topic,
+			struct mqtt_helper_buf payload);
+
+/**
+ * @brief Check a topic against a single filter, as done when scanning filters linearly.
+ */
+bool topic_filter_matches(const char *filter, const char *topic, size_t topic_len);
+
+/** @brief Compare trie dispatch with a linear filter scan and log the timings. */
+void topic_trie_bench_run(void);
+
+#endif /* TOPIC_TRIE_H_ */
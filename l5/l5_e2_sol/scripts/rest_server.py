@@ -0,0 +1,167 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2025 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+
+# Minimal REST server used as a local stand-in for rest.nordicsemi.academy when benchmarking.
+# POST /new returns a new client ID, PUT /<id> stores the request body and GET /<id> returns it
+# with an ETag, gzip-compressed if the client accepts it, or 304 Not Modified when
+# If-None-Match matches. Request bodies may be chunked. Connections are kept alive and pipelined
+# requests are answered in order. With --cert and --key the same endpoints are also served over
+# TLS, and with --files the files in a directory are served under /files/ with support for
+# Range requests.
+
+import argparse
+import gzip
+import hashlib
+import os
+import re
+import ssl
+import sys
+import threading
+import uuid
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+PORT = 8080
+TLS_PORT = 8443
+
+store = {}
+store_lock = threading.Lock()
+files_dir = None
+
+
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+
+    def log_message(self, format, *args):
+        pass
+
+    def reply(self, status, body=b"", headers=None):
+        self.send_response(status)
+        for name, value in (headers or {}).items():
+            self.send_header(name, value)
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        if self.command != "HEAD":
+            self.wfile.write(body)
+
+    def read_body(self):
+        if self.headers.get("Transfer-Encoding", "").lower() == "chunked":
+            return self.read_chunked()
+        length = int(self.headers.get("Content-Length", 0))
+        return self.rfile.read(length) if length > 0 else b""
+
+    def read_chunked(self):
+        body = bytearray()
+        chunks = 0
+        while True:
+            size = int(self.rfile.readline().split(b";")[0], 16)
+            if size == 0:
+                break
+            body += self.rfile.read(size)
+            self.rfile.readline()
+            chunks += 1
+        # Skip trailer fields up to the empty line.
+        while self.rfile.readline() not in (b"\r\n", b"\n", b""):
+            pass
+        print(f"{self.command} {self.path}: {len(body)} bytes in {chunks} chunks")
+        return bytes(body)
+
+    def do_POST(self):
+        self.read_body()
+        if self.path != "/new":
+            self.reply(404)
+            return
+        self.reply(200, str(uuid.uuid4()).encode(), {"Content-Type": "text/plain"})
+
+    def do_PUT(self):
+        body = self.read_body()
+        with store_lock:
+            store[self.path] = body
+        self.reply(200)
+
+    def do_GET(self):
+        if files_dir and self.path.startswith("/files/"):
+            self.send_file(os.path.basename(self.path))
+            return
+
+        with store_lock:
+            body = store.get(self.path)
+        if body is None:
+            self.reply(404)
+            return
+
+        headers = {"Content-Type": "text/plain", "Vary": "Accept-Encoding"}
+        if "gzip" in self.headers.get("Accept-Encoding", ""):
+            body = gzip.compress(body, mtime=0)
+            headers["Content-Encoding"] = "gzip"
+
+        etag = '"' + hashlib.sha1(body).hexdigest()[:16] + '"'
+        if self.headers.get("If-None-Match") == etag:
+            self.send_response(304)
+            self.send_header("ETag", etag)
+            self.end_headers()
+            return
+        headers["ETag"] = etag
+        self.reply(200, body, headers)
+
+    def send_file(self, name):
+        try:
+            with open(os.path.join(files_dir, name), "rb") as f:
+                data = f.read()
+        except OSError:
+            self.reply(404)
+            return
+
+        match = re.fullmatch(r"bytes=(\d+)-(\d*)", self.headers.get("Range", ""))
+        if not match:
+            self.reply(200, data, {"Content-Type": "application/octet-stream"})
+            return
+
+        start = int(match.group(1))
+        end = min(int(match.group(2)) if match.group(2) else len(data) - 1, len(data) - 1)
+        if start > end:
+            self.reply(416, headers={"Content-Range": f"bytes */{len(data)}"})
+            return
+
+        self.reply(206, data[start:end + 1], {
+            "Content-Type": "application/octet-stream",
+            "Content-Range": f"bytes {start}-{end}/{len(data)}",
+        })
+
+
+def serve(server, description):
+    print(f"Starting {description} server on port {server.server_address[1]}")
+    server.serve_forever()
+
+
+def main():
+    global files_dir
+
+    parser = argparse.ArgumentParser(description="Local stand-in for the REST server")
+    parser.add_argument("--port", type=int, default=PORT)
+    parser.add_argument("--tls-port", type=int, default=TLS_PORT)
+    parser.add_argument("--cert", help="Server certificate in PEM format, enables TLS")
+    parser.add_argument("--key", help="Private key of the server certificate in PEM format")
+    parser.add_argument("--files", help="Directory with files to serve under /files/")
+    args = parser.parse_args()
+
+    files_dir = args.files
+
+    if args.cert:
+        context = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+        context.load_cert_chain(args.cert, args.key)
+        tls_server = ThreadingHTTPServer(("0.0.0.0", args.tls_port), Handler)
+        tls_server.socket = context.wrap_socket(tls_server.socket, server_side=True)
+        threading.Thread(target=serve, args=(tls_server, "HTTPS"), daemon=True).start()
+
+    serve(ThreadingHTTPServer(("0.0.0.0", args.port), Handler), "HTTP")
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except KeyboardInterrupt:
+        print("\nKeyboard interrupt, exiting..")
+        sys.exit(130)
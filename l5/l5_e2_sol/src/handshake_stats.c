@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/net_mgmt.h>
+#include <zephyr/net/net_stats.h>
+
+#include "handshake_stats.h"
+
+LOG_MODULE_REGISTER(handshake_stats, LOG_LEVEL_INF);
+
+struct handshake_totals {
+	uint32_t count;
+	uint32_t ms;
+	uint32_t sent;
+	uint32_t received;
+};
+
+/* Connect cost, measured from zsock_connect() until it returns. The bytes are the TCP totals of
+ * all sockets, so they include the TCP handshake and any other traffic in that time.
+ */
+static int64_t start;
+static struct net_stats_tcp tcp_start;
+/* Index 0 counts full handshakes, index 1 handshakes that offered a cached session. */
+static struct handshake_totals totals[2];
+
+static void tcp_stats_get(struct net_stats_tcp *out)
+{
+	/* No interface means the totals over all interfaces. */
+	if (net_mgmt(NET_REQUEST_STATS_GET_TCP, NULL, out, sizeof(*out)) != 0) {
+		memset(out, 0, sizeof(*out));
+	}
+}
+
+void handshake_stats_start(void)
+{
+	tcp_stats_get(&tcp_start);
+	start = k_uptime_get();
+}
+
+void handshake_stats_done(bool session_offered)
+{
+	struct net_stats_tcp tcp_end;
+	struct handshake_totals *t = &totals[session_offered ? 1 : 0];
+	uint32_t ms = (uint32_t)(k_uptime_get() - start);
+	uint32_t sent;
+	uint32_t received;
+
+	tcp_stats_get(&tcp_end);
+	sent = (uint32_t)(tcp_end.bytes.sent - tcp_start.bytes.sent);
+	received = (uint32_t)(tcp_end.bytes.received - tcp_start.bytes.received);
+
+	t->count++;
+	t->ms += ms;
+	t->sent += sent;
+	t->received += received;
+
+	LOG_INF("Connect, %s: %d ms, %d TCP bytes sent, %d received", session_offered ?
+		"cached session offered" : "full handshake", ms, sent, received);
+}
+
+void handshake_stats_log(void)
+{
+	static const char *const names[] = {"full handshake", "cached session offered"};
+
+	for (size_t i = 0; i < ARRAY_SIZE(totals); i++) {
+		const struct handshake_totals *t = &totals[i];
+
+		if (t->count == 0) {
+			continue;
+		}
+
+		LOG_INF("Connects, %s: %d, average %d ms, %d TCP bytes sent, %d received",
+			names[i], t->count, t->ms / t->count, t->sent / t->count,
+			t->received / t->count);
+	}
+}
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef HANDSHAKE_STATS_H_
+#define HANDSHAKE_STATS_H_
+
+#include <stdbool.h>
+
+/** @brief Call right before zsock_connect() on a TLS socket. */
+void handshake_stats_start(void);
+
+/**
+ * @brief Call when zsock_connect() returns successfully, which is after the TLS handshake.
+ *
+ * Logs the connect cost: the time zsock_connect() took and the TCP bytes sent and received in
+ * that time. The bytes come from the TCP statistics of the whole stack, not of the socket, so they
+ * include the TCP handshake and the traffic of other sockets, and are only a handshake size when
+ * nothing else is sent.
+ *
+ * @param session_offered True if a cached session was expected to be offered for resumption. The
+ *			  server may still decline it, which shows up as a connect as large as a
+ *			  full one.
+ */
+void handshake_stats_done(bool session_offered);
+
+/** @brief Log the average connect time and bytes, with and without a cached session offered. */
+void handshake_stats_log(void);
+
+#endif /* HANDSHAKE_STATS_H_ */
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "http_async.h"
+#include "http_conn.h"
+
+LOG_MODULE_REGISTER(http_async, LOG_LEVEL_INF);
+
+struct async_slot {
+	struct k_work work;
+	struct http_request req;
+	http_async_done_t done;
+	void *user_data;
+	int32_t timeout;
+	int64_t submitted;
+	bool used;
+	char payload[CONFIG_HTTP_SAMPLE_ASYNC_PAYLOAD_SIZE];
+};
+
+static struct async_slot slots[CONFIG_HTTP_SAMPLE_ASYNC_QUEUE_SIZE];
+
+static struct k_work_q work_q;
+static K_THREAD_STACK_DEFINE(work_q_stack, CONFIG_HTTP_SAMPLE_ASYNC_STACK_SIZE);
+
+static struct http_async_stats stats;
+static uint64_t wait_ms_total;
+static uint64_t latency_ms_total;
+
+static K_MUTEX_DEFINE(async_lock);
+
+static void request_work_fn(struct k_work *work)
+{
+	struct async_slot *slot = CONTAINER_OF(work, struct async_slot, work);
+	http_async_done_t done = slot->done;
+	void *user_data = slot->user_data;
+	int32_t waited = (int32_t)(k_uptime_get() - slot->submitted);
+	bool expired = waited >= slot->timeout;
+	uint32_t latency;
+	int ret;
+
+	if (expired) {
+		LOG_WRN("Request waited %d ms in the queue, not sent", waited);
+		ret = -ETIMEDOUT;
+	} else {
+		ret = http_conn_request(&slot->req, slot->timeout - waited, user_data);
+	}
+
+	latency = (uint32_t)(k_uptime_get() - slot->submitted);
+
+	k_mutex_lock(&async_lock, K_FOREVER);
+
+	stats.depth--;
+	if (expired) {
+		stats.expired++;
+	} else if (ret < 0) {
+		stats.failed++;
+	} else {
+		stats.completed++;
+	}
+
+	wait_ms_total += waited;
+	latency_ms_total += latency;
+	stats.wait_max_ms = MAX(stats.wait_max_ms, (uint32_t)waited);
+	stats.latency_max_ms = MAX(stats.latency_max_ms, latency);
+	slot->used = false;
+
+	k_mutex_unlock(&async_lock);
+
+	if (done) {
+		done(ret, user_data);
+	}
+}
+
+int http_async_init(void)
+{
+	struct k_work_queue_config cfg = {
+		.name = "http_async",
+	};
+
+	for (size_t i = 0; i < ARRAY_SIZE(slots); i++) {
+		k_work_init(&slots[i].work, request_work_fn);
+	}
+
+	k_work_queue_init(&work_q);
+	k_work_queue_start(&work_q, work_q_stack, K_THREAD_STACK_SIZEOF(work_q_stack),
+			   K_LOWEST_APPLICATION_THREAD_PRIO, &cfg);
+
+	return 0;
+}
+
+int http_async_submit(const struct http_request *req, int32_t timeout, http_async_done_t done,
+		      void *user_data)
+{
+	int ret;
+	struct async_slot *slot = NULL;
+
+	if (req->payload_len > CONFIG_HTTP_SAMPLE_ASYNC_PAYLOAD_SIZE) {
+		return -EMSGSIZE;
+	}
+
+	k_mutex_lock(&async_lock, K_FOREVER);
+
+	for (size_t i = 0; i < ARRAY_SIZE(slots); i++) {
+		if (!slots[i].used) {
+			slot = &slots[i];
+			break;
+		}
+	}
+
+	if (!slot) {
+		stats.rejected++;
+		k_mutex_unlock(&async_lock);
+		return -ENOBUFS;
+	}
+
+	slot->req = *req;
+	if (req->payload_len > 0) {
+		memcpy(slot->payload, req->payload, req->payload_len);
+		slot->req.payload = slot->payload;
+	}
+
+	slot->done = done;
+	slot->user_data = user_data;
+	slot->timeout = timeout;
+	slot->submitted = k_uptime_get();
+
+	/* Fails with -ENODEV before http_async_init() has started the queue. */
+	ret = k_work_submit_to_queue(&work_q, &slot->work);
+	if (ret < 0) {
+		k_mutex_unlock(&async_lock);
+		return ret;
+	}
+
+	slot->used = true;
+
+	stats.submitted++;
+	stats.depth++;
+	stats.max_depth = MAX(stats.max_depth, stats.depth);
+
+	k_mutex_unlock(&async_lock);
+
+	return 0;
+}
+
+struct k_work_q *http_async_work_q(void)
+{
+	return &work_q;
+}
+
+void http_async_stats_get(struct http_async_stats *out)
+{
+	uint32_t done;
+
+	k_mutex_lock(&async_lock, K_FOREVER);
+	*out = stats;
+	done = stats.completed + stats.failed + stats.expired;
+	out->wait_avg_ms = done ? (uint32_t)(wait_ms_total / done) : 0;
+	out->latency_avg_ms = done ? (uint32_t)(latency_ms_total / done) : 0;
+	k_mutex_unlock(&async_lock);
+}
+
+void http_async_stats_log(void)
+{
+	struct http_async_stats s;
+
+	http_async_stats_get(&s);
+
+	LOG_INF("HTTP queue: %d queued, max %d, %d rejected", s.depth, s.max_depth, s.rejected);
+	LOG_INF("Submitted: %d, completed: %d, failed: %d, expired: %d", s.submitted, s.completed,
+		s.failed, s.expired);
+	LOG_INF("Queue wait avg: %d ms, max: %d ms. Latency avg: %d ms, max: %d ms", s.wait_avg_ms,
+		s.wait_max_ms, s.latency_avg_ms, s.latency_max_ms);
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef HTTP_ASYNC_H_
+#define HTTP_ASYNC_H_
+
+#include <stdint.h>
+#include <zephyr/kernel.h>
+#include <zephyr/net/http/client.h>
+
+/**
+ * @brief Called on the HTTP work queue when a request has completed.
+ *
+ * @param result    Return value of http_conn_request(), or -ETIMEDOUT if the request waited in
+ *		    the queue for its whole timeout and was not sent.
+ * @param user_data User data given to http_async_submit().
+ */
+typedef void (*http_async_done_t)(int result, void *user_data);
+
+/** @brief Counters kept by the HTTP work queue. */
+struct http_async_stats {
+	uint32_t submitted;
+	uint32_t completed;
+	uint32_t failed;
+	/* Requests refused because every queue slot was in use. */
+	uint32_t rejected;
+	/* Requests that timed out before they left the queue. */
+	uint32_t expired;
+	uint16_t depth;
+	uint16_t max_depth;
+	uint32_t wait_avg_ms;
+	uint32_t wait_max_ms;
+	uint32_t latency_avg_ms;
+	uint32_t latency_max_ms;
+};
+
+/** @brief Start the HTTP work queue thread. */
+int http_async_init(void);
+
+/**
+ * @brief Queue a request to be sent with http_conn_request() on the HTTP work queue.
+ *
+ * Returns without waiting for the network. The request and its payload are copied. The URL,
+ * host and header strings are not and must stay valid until the request has completed.
+ *
+ * @param req       Request to send.
+ * @param timeout   Time in milliseconds from now until the response must have arrived, including
+ *		    the time spent waiting in the queue.
+ * @param done      Completion callback, or NULL.
+ * @param user_data Passed to the response callback of the request and to the completion callback.
+ *
+ * @retval 0 if the request was queued.
+ * @retval -ENOBUFS if CONFIG_HTTP_SAMPLE_ASYNC_QUEUE_SIZE requests are already queued.
+ * @retval -EMSGSIZE if the payload is larger than CONFIG_HTTP_SAMPLE_ASYNC_PAYLOAD_SIZE.
+ * @retval Other negative error codes from k_work_submit_to_queue(), e.g. -ENODEV before
+ *         http_async_init().
+ */
+int http_async_submit(const struct http_request *req, int32_t timeout, http_async_done_t done,
+		      void *user_data);
+
+/** @brief Work queue that runs the requests, for other network work that must not block. */
+struct k_work_q *http_async_work_q(void);
+
+void http_async_stats_get(struct http_async_stats *stats);
+
+void http_async_stats_log(void);
+
+#endif /* HTTP_ASYNC_H_ */
@@ -0,0 +1,313 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/http/client.h>
+
+#include "http_bench.h"
+#include "http_conn.h"
+#include "http_pipeline.h"
+
+LOG_MODULE_REGISTER(http_bench, LOG_LEVEL_INF);
+
+#define BENCH_COUNT    CONFIG_HTTP_SAMPLE_BENCH_COUNT
+#define CLIENT_ID_SIZE 36
+
+struct bench_mode {
+	bool tls;
+	bool keepalive;
+	bool pipelined;
+};
+
+static const struct bench_mode modes[] = {
+	{.tls = false, .keepalive = false, .pipelined = false},
+	{.tls = false, .keepalive = true, .pipelined = false},
+	{.tls = false, .keepalive = true, .pipelined = true},
+	{.tls = true, .keepalive = false, .pipelined = false},
+	{.tls = true, .keepalive = true, .pipelined = false},
+	{.tls = true, .keepalive = true, .pipelined = true},
+};
+
+static struct sockaddr_in plain_addr;
+static struct sockaddr_in tls_addr;
+
+static char recv_buf[2048];
+static char url[CLIENT_ID_SIZE + 2];
+
+static uint64_t sent_us[BENCH_COUNT];
+static uint32_t latency_us[BENCH_COUNT];
+static uint32_t sample_count;
+static uint32_t error_count;
+
+static uint64_t now_us(void)
+{
+	return k_ticks_to_us_floor64(k_uptime_ticks());
+}
+
+static int compare_u32(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a;
+	uint32_t y = *(const uint32_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+static uint32_t percentile(const uint32_t *sorted, uint32_t count, uint32_t pct)
+{
+	if (count == 0) {
+		return 0;
+	}
+
+	return sorted[MIN((count * pct) / 100, count - 1)];
+}
+
+static void distribution_log(const char *name, uint32_t *samples, uint32_t count)
+{
+	uint64_t total = 0;
+
+	if (count == 0) {
+		LOG_INF("%s: no samples", name);
+		return;
+	}
+
+	qsort(samples, count, sizeof(samples[0]), compare_u32);
+
+	for (uint32_t i = 0; i < count; i++) {
+		total += samples[i];
+	}
+
+	LOG_INF("%s (us): min %u, p50 %u, p90 %u, p99 %u, max %u, avg %u", name, samples[0],
+		percentile(samples, count, 50), percentile(samples, count, 90),
+		percentile(samples, count, 99), samples[count - 1], (uint32_t)(total / count));
+}
+
+static int addr_resolve(const char *port, struct sockaddr_in *addr)
+{
+	int err;
+	struct zsock_addrinfo *result;
+	struct zsock_addrinfo hints = {.ai_family = AF_INET, .ai_socktype = SOCK_STREAM};
+
+	err = zsock_getaddrinfo(CONFIG_HTTP_SAMPLE_HOSTNAME, port, &hints, &result);
+	if (err != 0) {
+		LOG_ERR("getaddrinfo failed, err: %d, %s", err, zsock_gai_strerror(err));
+		return -EIO;
+	}
+
+	*addr = *(struct sockaddr_in *)result->ai_addr;
+	zsock_freeaddrinfo(result);
+
+	return 0;
+}
+
+static int bench_connect(const struct sockaddr_in *addr, bool tls)
+{
+	int err;
+	int sock;
+
+	sock = zsock_socket(AF_INET, SOCK_STREAM, tls ? IPPROTO_TLS_1_2 : IPPROTO_TCP);
+	if (sock < 0) {
+		return -errno;
+	}
+
+	if (tls) {
+		/* The local server has a self-signed certificate. */
+		err = http_conn_tls_setup(sock, -1, NULL);
+		if (err < 0) {
+			(void)zsock_close(sock);
+			return err;
+		}
+	}
+
+	err = zsock_connect(sock, (struct sockaddr *)addr, sizeof(*addr));
+	if (err < 0) {
+		err = -errno;
+		LOG_ERR("Connecting to server failed, err: %d", err);
+		(void)zsock_close(sock);
+		return err;
+	}
+
+	return sock;
+}
+
+static int connect_plain(void)
+{
+	return bench_connect(&plain_addr, false);
+}
+
+static int connect_tls(void)
+{
+	return bench_connect(&tls_addr, true);
+}
+
+static int id_response_cb(struct http_response *rsp, enum http_final_call final_data,
+			  void *user_data)
+{
+	if (rsp->body_frag_len > 0 && url[1] == '\0') {
+		memcpy(&url[1], rsp->body_frag_start, MIN(rsp->body_frag_len, CLIENT_ID_SIZE));
+	}
+
+	return 0;
+}
+
+static int bench_response_cb(struct http_response *rsp, enum http_final_call final_data,
+			     void *user_data)
+{
+	uint32_t i = POINTER_TO_UINT(user_data);
+
+	if (final_data != HTTP_DATA_FINAL) {
+		return 0;
+	}
+
+	if (rsp->http_status_code < 200 || rsp->http_status_code >= 300) {
+		error_count++;
+		return 0;
+	}
+
+	latency_us[sample_count++] = (uint32_t)(now_us() - sent_us[i]);
+	return 0;
+}
+
+static void request_init(struct http_request *req, enum http_method method, const char *path)
+{
+	memset(req, 0, sizeof(*req));
+	req->method = method;
+	req->url = path;
+	req->host = CONFIG_HTTP_SAMPLE_HOSTNAME;
+	req->protocol = "HTTP/1.1";
+	req->recv_buf = recv_buf;
+	req->recv_buf_len = sizeof(recv_buf);
+}
+
+static int client_id_get(void)
+{
+	int ret;
+	struct http_request req;
+
+	memset(url, 0, sizeof(url));
+	url[0] = '/';
+
+	request_init(&req, HTTP_POST, "/new");
+	req.response = id_response_cb;
+
+	ret = http_conn_request(&req, CONFIG_HTTP_SAMPLE_BENCH_TIMEOUT_MS, NULL);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return url[1] != '\0' ? 0 : -EBADMSG;
+}
+
+static int put_send(uint32_t i, bool pipelined)
+{
+	int ret;
+	struct http_request req;
+	char payload[12];
+
+	request_init(&req, HTTP_PUT, url);
+	req.response = bench_response_cb;
+	req.payload = payload;
+	req.payload_len = snprintk(payload, sizeof(payload), "%u", i);
+
+	sent_us[i] = now_us();
+
+	if (!IS_ENABLED(CONFIG_HTTP_SAMPLE_PIPELINE) || !pipelined) {
+		return http_conn_request(&req, CONFIG_HTTP_SAMPLE_BENCH_TIMEOUT_MS,
+					 UINT_TO_POINTER(i));
+	}
+
+	ret = http_pipeline_add(&req, UINT_TO_POINTER(i));
+	if (ret == -ENOBUFS) {
+		/* The pipeline is full, send the burst and start the next one. */
+		(void)http_pipeline_flush(CONFIG_HTTP_SAMPLE_BENCH_TIMEOUT_MS);
+		sent_us[i] = now_us();
+		ret = http_pipeline_add(&req, UINT_TO_POINTER(i));
+	}
+
+	return ret;
+}
+
+static void mode_run(const struct bench_mode *mode)
+{
+	char name[40];
+	int ret;
+	int64_t start;
+	uint32_t ms;
+	uint32_t lost;
+	uint64_t rate_x100;
+
+	snprintk(name, sizeof(name), "%s, %s, %s", mode->tls ? "TLS" : "plain",
+		 mode->keepalive ? "keep-alive" : "close",
+		 mode->pipelined ? "pipelined" : "sequential");
+
+	(void)http_conn_init(mode->tls ? connect_tls : connect_plain);
+	http_conn_keepalive_set(mode->keepalive);
+
+	ret = client_id_get();
+	if (ret < 0) {
+		LOG_ERR("%s: failed to get a client ID, err: %d", name, ret);
+		return;
+	}
+
+	/* Start without a connection, so the first request includes connection setup. */
+	http_conn_close();
+
+	sample_count = 0;
+	error_count = 0;
+	start = k_uptime_get();
+
+	for (uint32_t i = 0; i < BENCH_COUNT; i++) {
+		(void)put_send(i, mode->pipelined);
+	}
+
+	if (IS_ENABLED(CONFIG_HTTP_SAMPLE_PIPELINE) && mode->pipelined) {
+		(void)http_pipeline_flush(CONFIG_HTTP_SAMPLE_BENCH_TIMEOUT_MS);
+	}
+
+	ms = MAX((uint32_t)(k_uptime_get() - start), 1);
+	lost = BENCH_COUNT - sample_count - error_count;
+	rate_x100 = (uint64_t)sample_count * 100000 / ms;
+
+	LOG_INF("%s: %u ok, %u error responses, %u lost, %u.%02u requests/s", name, sample_count,
+		error_count, lost, (uint32_t)(rate_x100 / 100), (uint32_t)(rate_x100 % 100));
+	distribution_log("Latency", latency_us, sample_count);
+}
+
+int http_bench_run(void)
+{
+	int err;
+
+	err = addr_resolve(CONFIG_HTTP_SAMPLE_BENCH_PORT, &plain_addr);
+	if (!err && IS_ENABLED(CONFIG_HTTP_SAMPLE_BENCH_TLS)) {
+		err = addr_resolve(CONFIG_HTTP_SAMPLE_BENCH_TLS_PORT, &tls_addr);
+	}
+	if (err) {
+		return err;
+	}
+
+	LOG_INF("Benchmark: %d PUT requests per run to %s", BENCH_COUNT,
+		CONFIG_HTTP_SAMPLE_HOSTNAME);
+
+	for (size_t i = 0; i < ARRAY_SIZE(modes); i++) {
+		if (modes[i].tls && !IS_ENABLED(CONFIG_HTTP_SAMPLE_BENCH_TLS)) {
+			continue;
+		}
+
+		if (modes[i].pipelined && !IS_ENABLED(CONFIG_HTTP_SAMPLE_PIPELINE)) {
+			continue;
+		}
+
+		mode_run(&modes[i]);
+	}
+
+	LOG_INF("Benchmark done");
+	return 0;
+}
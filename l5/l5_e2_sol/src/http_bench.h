@@ -0,0 +1,22 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef HTTP_BENCH_H_
+#define HTTP_BENCH_H_
+
+/**
+ * @brief Run the REST benchmark against CONFIG_HTTP_SAMPLE_HOSTNAME.
+ *
+ * Sends CONFIG_HTTP_SAMPLE_BENCH_COUNT PUT requests in every combination of plain or TLS,
+ * Connection: close or keep-alive, and sequential or pipelined requests that the configuration
+ * allows, and logs requests per second and latency percentiles for each. Replaces the connect
+ * function of the connection manager.
+ *
+ * @return 0 on success, or a negative error code if the server could not be resolved.
+ */
+int http_bench_run(void);
+
+#endif /* HTTP_BENCH_H_ */
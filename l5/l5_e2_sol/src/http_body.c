@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/crc.h>
+
+#include "http_body.h"
+
+LOG_MODULE_REGISTER(http_body, LOG_LEVEL_INF);
+
+/* The log sink prints the first LOG_MAX bytes of a body, in lines of LOG_LINE_SIZE bytes. */
+#define LOG_MAX	      256
+#define LOG_LINE_SIZE 64
+
+void http_body_init(struct http_body *body, const struct http_body_sink *sink)
+{
+	memset(body, 0, sizeof(*body));
+	body->sink = sink;
+}
+
+static void body_end(struct http_body *body, int status)
+{
+	if (body->sink->end) {
+		body->sink->end(status, body->sink->ctx);
+	}
+}
+
+int http_body_response_cb(struct http_response *rsp, enum http_final_call final_data,
+			  void *user_data)
+{
+	struct http_body *body = user_data;
+	const struct http_body_sink *sink = body->sink;
+	int err;
+
+	if (!body->started) {
+		body->started = true;
+		body->offset = 0;
+		body->status = sink->begin ? sink->begin(rsp, sink->ctx) : 0;
+		if (body->status < 0) {
+			body_end(body, body->status);
+		}
+	}
+
+	if (body->status == 0 && rsp->body_frag_len > 0) {
+		err = sink->write(body->offset, rsp->body_frag_start, rsp->body_frag_len,
+				  sink->ctx);
+		if (err < 0) {
+			body->status = err;
+			body_end(body, err);
+		}
+
+		body->offset += rsp->body_frag_len;
+	}
+
+	if (final_data == HTTP_DATA_FINAL) {
+		if (body->status == 0) {
+			body_end(body, 0);
+		}
+
+		body->started = false;
+	}
+
+	return body->status;
+}
+
+void http_body_abort(struct http_body *body, int err)
+{
+	if (!body->started) {
+		return;
+	}
+
+	if (body->status == 0) {
+		body_end(body, err);
+	}
+
+	body->started = false;
+}
+
+struct log_sink_state {
+	uint32_t crc;
+	size_t len;
+};
+
+static struct log_sink_state log_state;
+
+static int log_begin(const struct http_response *rsp, void *ctx)
+{
+	struct log_sink_state *state = ctx;
+
+	LOG_INF("Response status: %s", rsp->http_status);
+
+	state->crc = 0;
+	state->len = 0;
+	return 0;
+}
+
+static int log_write(size_t offset, const uint8_t *data, size_t len, void *ctx)
+{
+	struct log_sink_state *state = ctx;
+	char line[LOG_LINE_SIZE + 1];
+	size_t n;
+
+	state->crc = crc32_ieee_update(state->crc, data, len);
+	state->len += len;
+
+	for (size_t i = 0; i < len && offset + i < LOG_MAX; i += n) {
+		n = MIN(len - i, MIN(LOG_LINE_SIZE, LOG_MAX - (offset + i)));
+		memcpy(line, data + i, n);
+		line[n] = '\0';
+		LOG_INF("Received: %s", line);
+	}
+
+	return 0;
+}
+
+static void log_end(int status, void *ctx)
+{
+	struct log_sink_state *state = ctx;
+
+	if (status < 0) {
+		LOG_WRN("Body aborted after %zu bytes, err: %d", state->len, status);
+		return;
+	}
+
+	LOG_INF("Body: %zu bytes, CRC32 0x%08x", state->len, state->crc);
+}
+
+const struct http_body_sink http_body_log_sink = {
+	.begin = log_begin,
+	.write = log_write,
+	.end = log_end,
+	.ctx = &log_state,
+};
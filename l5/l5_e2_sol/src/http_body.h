@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef HTTP_BODY_H_
+#define HTTP_BODY_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/net/http/client.h>
+
+/**
+ * @brief Consumer of a response body.
+ *
+ * Body fragments are passed to the sink straight from the receive buffer as they arrive, so a
+ * body of any length can be handled with the 2 KB receive buffer. Returning a negative error
+ * code from begin() or write() aborts the request.
+ */
+struct http_body_sink {
+	/* Called once the status line and headers of a response have arrived. */
+	int (*begin)(const struct http_response *rsp, void *ctx);
+	int (*write)(size_t offset, const uint8_t *data, size_t len, void *ctx);
+	/* Called with 0 when the body is complete, or a negative error code if it was aborted. */
+	void (*end)(int status, void *ctx);
+	void *ctx;
+};
+
+/** @brief State of one response being delivered to a sink. */
+struct http_body {
+	const struct http_body_sink *sink;
+	size_t offset;
+	int status;
+	bool started;
+};
+
+/**
+ * @brief Prepare a body for delivery to a sink.
+ *
+ * The body can be reused for any number of responses, one at a time.
+ */
+void http_body_init(struct http_body *body, const struct http_body_sink *sink);
+
+/**
+ * @brief Response callback that feeds a sink.
+ *
+ * Set as the response callback of a request and pass the struct http_body as its user data.
+ */
+int http_body_response_cb(struct http_response *rsp, enum http_final_call final_data,
+			  void *user_data);
+
+/**
+ * @brief End delivery of a response that did not complete, e.g. because the request failed.
+ *
+ * Calls the end() callback of the sink with the error if a body was started.
+ */
+void http_body_abort(struct http_body *body, int err);
+
+/** @brief Sink that logs the start of the body and its length and CRC32. */
+extern const struct http_body_sink http_body_log_sink;
+
+#endif /* HTTP_BODY_H_ */
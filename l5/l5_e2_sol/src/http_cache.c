@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <strings.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/net/http/client.h>
+#include <zephyr/net/http/parser.h>
+
+#include "http_cache.h"
+
+LOG_MODULE_REGISTER(http_cache, LOG_LEVEL_INF);
+
+#define URL_LEN	 HTTP_CACHE_URL_LEN
+#define ETAG_LEN HTTP_CACHE_ETAG_LEN
+/* Last-Modified is an IMF-fixdate such as "Sun, 06 Nov 1994 08:49:37 GMT". */
+#define DATE_LEN 32
+
+struct cache_entry {
+	char url[URL_LEN];
+	char etag[ETAG_LEN];
+	char last_modified[DATE_LEN];
+	uint8_t body[CONFIG_HTTP_SAMPLE_CACHE_BODY_SIZE];
+	size_t len;
+	/* Value of use_clock when the entry was last used, 0 if the entry holds no response. */
+	uint32_t last_used;
+};
+
+static struct cache_entry entries[CONFIG_HTTP_SAMPLE_CACHE_ENTRIES];
+static uint32_t use_clock;
+static struct http_cache_stats stats;
+
+static K_MUTEX_DEFINE(cache_lock);
+
+/* State of the response being received. Responses arrive one at a time, also when pipelined. */
+static char rsp_etag[ETAG_LEN];
+static char rsp_last_modified[DATE_LEN];
+static char *header_value;
+static size_t header_value_size;
+/* Entry that the response body is copied into, NULL if it is not stored. */
+static struct cache_entry *filling;
+static bool not_modified;
+
+static int cache_begin(const struct http_response *rsp, void *ctx);
+static int cache_write(size_t offset, const uint8_t *data, size_t len, void *ctx);
+static void cache_end(int status, void *ctx);
+
+static struct cache_entry *entry_find(const char *url)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(entries); i++) {
+		if (entries[i].last_used != 0 && strcmp(entries[i].url, url) == 0) {
+			return &entries[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Take a free entry, or the least recently used one. */
+static struct cache_entry *entry_claim(void)
+{
+	struct cache_entry *lru = &entries[0];
+
+	for (size_t i = 1; i < ARRAY_SIZE(entries) && lru->last_used != 0; i++) {
+		if (entries[i].last_used < lru->last_used) {
+			lru = &entries[i];
+		}
+	}
+
+	if (lru->last_used != 0) {
+		LOG_DBG("Evicting %s", lru->url);
+		stats.evicted++;
+		lru->last_used = 0;
+	}
+
+	return lru;
+}
+
+static bool field_is(const char *at, size_t length, const char *name)
+{
+	return length == strlen(name) && strncasecmp(at, name, length) == 0;
+}
+
+/* Requests can be pipelined or queued, so the validators are collected per response. */
+static int on_message_begin(struct http_parser *parser)
+{
+	rsp_etag[0] = '\0';
+	rsp_last_modified[0] = '\0';
+	header_value = NULL;
+
+	return 0;
+}
+
+static int on_header_field(struct http_parser *parser, const char *at, size_t length)
+{
+	header_value = NULL;
+
+	if (field_is(at, length, "ETag")) {
+		header_value = rsp_etag;
+		header_value_size = sizeof(rsp_etag);
+	} else if (field_is(at, length, "Last-Modified")) {
+		header_value = rsp_last_modified;
+		header_value_size = sizeof(rsp_last_modified);
+	}
+
+	return 0;
+}
+
+static int on_header_value(struct http_parser *parser, const char *at, size_t length)
+{
+	size_t used;
+
+	if (!header_value) {
+		return 0;
+	}
+
+	/* The value can arrive in parts when it spans two receive buffers. */
+	used = strlen(header_value);
+	if (used + length >= header_value_size) {
+		/* Too long to send back, so it cannot be used as a validator. */
+		header_value[0] = '\0';
+		header_value = NULL;
+		return 0;
+	}
+
+	memcpy(header_value + used, at, length);
+	header_value[used + length] = '\0';
+
+	return 0;
+}
+
+static const struct http_parser_settings header_cb = {
+	.on_message_begin = on_message_begin,
+	.on_header_field = on_header_field,
+	.on_header_value = on_header_value,
+};
+
+void http_cache_request_prepare(struct http_cache_request *cache, struct http_request *req,
+				struct http_conn_headers *headers,
+				const struct http_body_sink *sink)
+{
+	struct cache_entry *entry;
+	int err = 0;
+
+	cache->sink = (struct http_body_sink){
+		.begin = cache_begin,
+		.write = cache_write,
+		.end = cache_end,
+		.ctx = cache,
+	};
+	cache->next = sink;
+	snprintk(cache->url, sizeof(cache->url), "%s", req->url);
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	stats.requests++;
+
+	entry = entry_find(cache->url);
+	if (entry && entry->etag[0] != '\0') {
+		snprintk(cache->cond_header, sizeof(cache->cond_header), "If-None-Match: %s\r\n",
+			 entry->etag);
+		err = http_conn_header_add(headers, cache->cond_header);
+	} else if (entry) {
+		snprintk(cache->cond_header, sizeof(cache->cond_header),
+			 "If-Modified-Since: %s\r\n", entry->last_modified);
+		err = http_conn_header_add(headers, cache->cond_header);
+	}
+
+	if (err) {
+		LOG_WRN("No room for the validator, the request is not conditional");
+	}
+
+	req->http_cb = &header_cb;
+
+	k_mutex_unlock(&cache_lock);
+}
+
+/* Start storing a 200 response, or drop the outdated copy if it cannot be stored. */
+static void store_begin(const struct http_response *rsp, const char *url,
+			struct cache_entry *entry)
+{
+	if ((rsp_etag[0] == '\0' && rsp_last_modified[0] == '\0') ||
+	    rsp->content_length > sizeof(entry->body) || strlen(url) >= URL_LEN - 1) {
+		stats.uncacheable++;
+		if (entry) {
+			entry->last_used = 0;
+		}
+		return;
+	}
+
+	filling = entry ? entry : entry_claim();
+	filling->last_used = 0;
+	filling->len = 0;
+	strcpy(filling->url, url);
+	strcpy(filling->etag, rsp_etag);
+	strcpy(filling->last_modified, rsp_last_modified);
+}
+
+static int cache_begin(const struct http_response *rsp, void *ctx)
+{
+	int err = 0;
+	struct http_cache_request *cache = ctx;
+	const struct http_body_sink *next = cache->next;
+	struct cache_entry *entry;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	filling = NULL;
+	not_modified = false;
+	entry = entry_find(cache->url);
+
+	if (rsp->http_status_code == 304 && entry) {
+		not_modified = true;
+		entry->last_used = ++use_clock;
+		stats.hits++;
+		stats.bytes_saved += entry->len;
+	} else if (rsp->http_status_code == 200) {
+		store_begin(rsp, cache->url, entry);
+	}
+
+	if (next->begin) {
+		err = next->begin(rsp, next->ctx);
+	}
+
+	if (err == 0 && not_modified) {
+		LOG_INF("%s not modified, using %zu cached bytes", cache->url, entry->len);
+		err = next->write(0, entry->body, entry->len, next->ctx);
+	}
+
+	k_mutex_unlock(&cache_lock);
+
+	return err;
+}
+
+static int cache_write(size_t offset, const uint8_t *data, size_t len, void *ctx)
+{
+	const struct http_body_sink *next = ((struct http_cache_request *)ctx)->next;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	if (filling && offset + len > sizeof(filling->body)) {
+		/* No Content-Length, and the body turned out too large. */
+		stats.uncacheable++;
+		filling = NULL;
+	} else if (filling) {
+		memcpy(filling->body + offset, data, len);
+		filling->len = offset + len;
+	}
+
+	k_mutex_unlock(&cache_lock);
+
+	/* A 304 has no body of its own, the cached one was passed on in cache_begin(). */
+	return next->write(offset, data, len, next->ctx);
+}
+
+static void cache_end(int status, void *ctx)
+{
+	const struct http_body_sink *next = ((struct http_cache_request *)ctx)->next;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	if (filling && status == 0) {
+		filling->last_used = ++use_clock;
+		stats.stored++;
+	}
+
+	filling = NULL;
+
+	k_mutex_unlock(&cache_lock);
+
+	if (next->end) {
+		next->end(status, next->ctx);
+	}
+}
+
+void http_cache_stats_get(struct http_cache_stats *out)
+{
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	*out = stats;
+	k_mutex_unlock(&cache_lock);
+}
+
+void http_cache_stats_log(void)
+{
+	struct http_cache_stats s;
+
+	http_cache_stats_get(&s);
+
+	LOG_INF("%d GET requests, %d not modified, hit ratio %d%%", s.requests, s.hits,
+		s.requests ? s.hits * 100 / s.requests : 0);
+	LOG_INF("Stored: %d, evicted: %d, not cacheable: %d", s.stored, s.evicted, s.uncacheable);
+	LOG_INF("Body bytes not transferred again: %d", s.bytes_saved);
+}
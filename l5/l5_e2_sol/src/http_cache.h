@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef HTTP_CACHE_H_
+#define HTTP_CACHE_H_
+
+#include <stdint.h>
+#include <zephyr/net/http/client.h>
+
+#include "http_body.h"
+#include "http_conn.h"
+
+/** @brief Counters kept by the response cache. */
+struct http_cache_stats {
+	uint32_t requests;
+	/* Requests answered with 304 Not Modified and served from the cache. */
+	uint32_t hits;
+	uint32_t stored;
+	uint32_t evicted;
+	/* Responses not stored because they had no validator or did not fit in an entry. */
+	uint32_t uncacheable;
+	/* Body bytes served from the cache instead of being transferred again. */
+	uint32_t bytes_saved;
+};
+
+/** @brief Longest URL and ETag that are cached, including the terminating NUL. */
+#define HTTP_CACHE_URL_LEN  64
+#define HTTP_CACHE_ETAG_LEN 64
+
+/** @brief State of one request through the cache, filled by http_cache_request_prepare(). */
+struct http_cache_request {
+	/* Sink to send the request with, its ctx points back to this request. */
+	struct http_body_sink sink;
+	const struct http_body_sink *next;
+	char url[HTTP_CACHE_URL_LEN];
+	char cond_header[sizeof("If-None-Match: \r\n") + HTTP_CACHE_ETAG_LEN];
+};
+
+/**
+ * @brief Make a GET request conditional on the cached response for its URL.
+ *
+ * If the URL is cached, If-None-Match or If-Modified-Since is added to @p headers, which must be
+ * the optional headers of the request set up with http_conn_headers_init(). The header is kept in
+ * @p cache. The ETag and Last-Modified headers of the response are collected through the
+ * request's http_cb, which must not be set by the caller.
+ *
+ * Send the request with a struct http_body initialized with the sink in @p cache. The body is
+ * passed on to @p sink, on 304 Not Modified from the cache. @p cache must stay valid until the
+ * response has been handled. Requests in flight at the same time, e.g. when pipelined, each need
+ * their own.
+ */
+void http_cache_request_prepare(struct http_cache_request *cache, struct http_request *req,
+				struct http_conn_headers *headers,
+				const struct http_body_sink *sink);
+
+void http_cache_stats_get(struct http_cache_stats *stats);
+
+void http_cache_stats_log(void);
+
+#endif /* HTTP_CACHE_H_ */
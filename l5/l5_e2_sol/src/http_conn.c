@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/tls_credentials.h>
+#include <zephyr/net/http/client.h>
+#include <zephyr/net/http/parser.h>
+
+#include "http_conn.h"
+
+LOG_MODULE_REGISTER(http_conn, LOG_LEVEL_INF);
+
+/* Retry delay of idle_work while a request holds the connection */
+#define IDLE_RETRY_MS 100
+
+static const char *keepalive_headers[] = {"Connection: keep-alive\r\n", NULL};
+static const char *close_headers[] = {"Connection: close\r\n", NULL};
+
+static http_conn_connect_t connect_fn;
+static int sock = -1;
+static bool keepalive = IS_ENABLED(CONFIG_HTTP_SAMPLE_KEEPALIVE);
+static struct http_conn_stats stats;
+/* When the connection was last released, for idle_work. */
+static int64_t idle_since;
+
+static K_MUTEX_DEFINE(conn_lock);
+
+static void idle_work_fn(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(idle_work, idle_work_fn);
+
+/* Must be called with conn_lock held. */
+static void conn_close(void)
+{
+	if (sock < 0) {
+		return;
+	}
+
+	LOG_INF("Closing socket: %d", sock);
+	(void)zsock_close(sock);
+	sock = -1;
+	(void)k_work_cancel_delayable(&idle_work);
+}
+
+/* An idle connection has nothing to read unless the server closed it or sent an alert. */
+static bool conn_stale(void)
+{
+	struct zsock_pollfd fds = {
+		.fd = sock,
+		.events = ZSOCK_POLLIN,
+	};
+
+	return zsock_poll(&fds, 1, 0) != 0;
+}
+
+static void idle_work_fn(struct k_work *work)
+{
+	int64_t idle_ms;
+
+	/* Runs on the system work queue, which must not wait for a request to finish. */
+	if (k_mutex_lock(&conn_lock, K_NO_WAIT)) {
+		(void)k_work_reschedule(&idle_work, K_MSEC(IDLE_RETRY_MS));
+		return;
+	}
+
+	idle_ms = k_uptime_get() - idle_since;
+
+	if (sock < 0) {
+		/* Already closed */
+	} else if (idle_ms < CONFIG_HTTP_SAMPLE_KEEPALIVE_IDLE_S * MSEC_PER_SEC) {
+		/* Used again after the work was queued */
+		(void)k_work_reschedule(&idle_work,
+					K_MSEC(CONFIG_HTTP_SAMPLE_KEEPALIVE_IDLE_S * MSEC_PER_SEC -
+					       idle_ms));
+	} else {
+		LOG_INF("Connection idle for %d s", CONFIG_HTTP_SAMPLE_KEEPALIVE_IDLE_S);
+		conn_close();
+	}
+
+	k_mutex_unlock(&conn_lock);
+}
+
+int http_conn_init(http_conn_connect_t connect)
+{
+	if (!connect) {
+		return -EINVAL;
+	}
+
+	connect_fn = connect;
+	return 0;
+}
+
+int http_conn_tls_setup(int sock, int sec_tag, const char *hostname)
+{
+	int err;
+
+	if (sec_tag >= 0) {
+		sec_tag_t sec_tag_opt[] = {
+			sec_tag,
+		};
+
+		err = zsock_setsockopt(sock, SOL_TLS, TLS_SEC_TAG_LIST, sec_tag_opt,
+				       sizeof(sec_tag_opt));
+	} else {
+		int verify = TLS_PEER_VERIFY_NONE;
+
+		err = zsock_setsockopt(sock, SOL_TLS, TLS_PEER_VERIFY, &verify, sizeof(verify));
+	}
+
+	if (!err && hostname) {
+		err = zsock_setsockopt(sock, SOL_TLS, TLS_HOSTNAME, hostname, strlen(hostname) + 1);
+	}
+
+	if (!err && IS_ENABLED(CONFIG_HTTP_SAMPLE_TLS_SESSION_CACHE)) {
+		int cache = TLS_SESSION_CACHE_ENABLED;
+
+		err = zsock_setsockopt(sock, SOL_TLS, TLS_SESSION_CACHE, &cache, sizeof(cache));
+	}
+
+	return err < 0 ? -errno : 0;
+}
+
+/* Must be called with conn_lock held. */
+static int conn_open(void)
+{
+	int64_t start = k_uptime_get();
+
+	sock = connect_fn();
+	if (sock < 0) {
+		return sock;
+	}
+
+	stats.connects++;
+	stats.connect_ms_total += (uint32_t)(k_uptime_get() - start);
+
+	return 0;
+}
+
+/* Must be called with conn_lock held. */
+static int conn_get(bool *reused)
+{
+	int ret;
+
+	*reused = sock >= 0;
+
+	if (*reused && conn_stale()) {
+		LOG_INF("Server closed the idle connection, reconnecting");
+		stats.stale++;
+		conn_close();
+		*reused = false;
+	}
+
+	if (sock < 0) {
+		ret = conn_open();
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	(void)k_work_cancel_delayable(&idle_work);
+	return sock;
+}
+
+/* Must be called with conn_lock held. */
+static void conn_put(bool keep_open)
+{
+	if (!keepalive || !keep_open) {
+		conn_close();
+		return;
+	}
+
+	idle_since = k_uptime_get();
+	(void)k_work_reschedule(&idle_work, K_SECONDS(CONFIG_HTTP_SAMPLE_KEEPALIVE_IDLE_S));
+}
+
+int http_conn_request(struct http_request *req, int32_t timeout, void *user_data)
+{
+	int ret;
+	bool reused = false;
+	int64_t start = k_uptime_get();
+	uint32_t elapsed;
+
+	/* Header fields of the caller would be replaced by the Connection header and lost. */
+	if (req->header_fields && req->header_fields != keepalive_headers &&
+	    req->header_fields != close_headers) {
+		LOG_ERR("Header fields are set by the caller, use optional headers instead");
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&conn_lock, K_FOREVER);
+
+	req->header_fields = keepalive ? keepalive_headers : close_headers;
+
+	for (int attempt = 0; attempt < 2; attempt++) {
+		ret = conn_get(&reused);
+		if (ret < 0) {
+			k_mutex_unlock(&conn_lock);
+			return ret;
+		}
+
+		ret = http_client_req(sock, req, timeout, user_data);
+		if (ret >= 0 || !reused) {
+			break;
+		}
+
+		LOG_INF("Request failed on reused connection, err: %d, retrying", ret);
+		conn_close();
+	}
+
+	elapsed = (uint32_t)(k_uptime_get() - start);
+	stats.requests++;
+
+	if (reused) {
+		stats.reused++;
+		stats.reused_request_ms_total += elapsed;
+		LOG_INF("Request took %d ms on a reused connection, about %d ms of connection setup "
+			"saved", elapsed, stats.connect_ms_total / MAX(stats.connects, 1));
+	} else {
+		stats.fresh_request_ms_total += elapsed;
+		LOG_INF("Request took %d ms including connection setup", elapsed);
+	}
+
+	conn_put(ret >= 0 && http_should_keep_alive(&req->internal.parser));
+
+	k_mutex_unlock(&conn_lock);
+	return ret;
+}
+
+void http_conn_headers_init(struct http_conn_headers *headers, struct http_request *req)
+{
+	memset(headers, 0, sizeof(*headers));
+	req->optional_headers = headers->fields;
+}
+
+int http_conn_header_add(struct http_conn_headers *headers, const char *header)
+{
+	if (headers->count >= HTTP_CONN_HEADERS_MAX) {
+		return -ENOMEM;
+	}
+
+	headers->fields[headers->count++] = header;
+
+	return 0;
+}
+
+int http_conn_acquire(bool *reused)
+{
+	int ret;
+
+	k_mutex_lock(&conn_lock, K_FOREVER);
+
+	ret = conn_get(reused);
+	if (ret < 0) {
+		k_mutex_unlock(&conn_lock);
+	}
+
+	return ret;
+}
+
+void http_conn_release(bool keep_open)
+{
+	conn_put(keep_open);
+	k_mutex_unlock(&conn_lock);
+}
+
+void http_conn_keepalive_set(bool enable)
+{
+	k_mutex_lock(&conn_lock, K_FOREVER);
+	keepalive = enable;
+	conn_close();
+	k_mutex_unlock(&conn_lock);
+}
+
+void http_conn_close(void)
+{
+	k_mutex_lock(&conn_lock, K_FOREVER);
+	conn_close();
+	k_mutex_unlock(&conn_lock);
+}
+
+void http_conn_stats_get(struct http_conn_stats *out)
+{
+	k_mutex_lock(&conn_lock, K_FOREVER);
+	*out = stats;
+	k_mutex_unlock(&conn_lock);
+}
+
+void http_conn_stats_log(void)
+{
+	struct http_conn_stats s;
+	uint32_t fresh = 0;
+
+	http_conn_stats_get(&s);
+	fresh = s.requests - s.reused;
+
+	LOG_INF("%d requests, %d on reused connections, %d connections opened, %d found stale",
+		s.requests, s.reused, s.connects, s.stale);
+	LOG_INF("Average request: %d ms with connection setup, %d ms reused",
+		fresh ? s.fresh_request_ms_total / fresh : 0,
+		s.reused ? s.reused_request_ms_total / s.reused : 0);
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef HTTP_CONN_H_
+#define HTTP_CONN_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/net/http/client.h>
+
+/* Optional headers that can be added to one request by all modules together. */
+#define HTTP_CONN_HEADERS_MAX 4
+
+/** @brief Function that opens a connection to the server and returns its socket. */
+typedef int (*http_conn_connect_t)(void);
+
+/** @brief Counters kept by the connection manager. */
+struct http_conn_stats {
+	uint32_t requests;
+	/* Requests sent on a connection left open by an earlier request. */
+	uint32_t reused;
+	uint32_t connects;
+	/* Idle connections found closed by the server before they could be reused. */
+	uint32_t stale;
+	uint32_t connect_ms_total;
+	uint32_t fresh_request_ms_total;
+	uint32_t reused_request_ms_total;
+};
+
+/** @brief Optional headers of a request that several modules add to. */
+struct http_conn_headers {
+	const char *fields[HTTP_CONN_HEADERS_MAX + 1];
+	size_t count;
+};
+
+/**
+ * @brief Initialize the connection manager.
+ *
+ * @param connect Called whenever a new connection is needed.
+ */
+int http_conn_init(http_conn_connect_t connect);
+
+/**
+ * @brief Configure a TLS socket before it is connected.
+ *
+ * Also used for connections that do not go through the connection manager. Enables the TLS
+ * session cache when CONFIG_HTTP_SAMPLE_TLS_SESSION_CACHE is set.
+ *
+ * @param sec_tag Security tag of the CA certificate, or a negative value to skip verifying the
+ *		  server, e.g. a local server with a self-signed certificate.
+ * @param hostname Name the server certificate is checked against, or NULL.
+ *
+ * @retval 0 on success.
+ * @retval Negative error code of the option that could not be set.
+ */
+int http_conn_tls_setup(int sock, int sec_tag, const char *hostname);
+
+/**
+ * @brief Send a request and wait for the complete response.
+ *
+ * Opens a connection if none is open. req->header_fields is set to the Connection header by this
+ * function, other headers must go in req->optional_headers. With keep-alive on, the connection is
+ * kept open for the next request unless the server asks to close it, and is closed after
+ * CONFIG_HTTP_SAMPLE_KEEPALIVE_IDLE_S without requests. A request that fails on a reused
+ * connection is sent again once on a new connection.
+ *
+ * @retval -EINVAL if the caller set req->header_fields.
+ * @return Number of bytes received, or a negative error code.
+ */
+int http_conn_request(struct http_request *req, int32_t timeout, void *user_data);
+
+/**
+ * @brief Make an empty header list the optional headers of a request.
+ *
+ * The list is not copied when the request is queued, so it must stay valid until the request has
+ * completed, like the header strings.
+ */
+void http_conn_headers_init(struct http_conn_headers *headers, struct http_request *req);
+
+/**
+ * @brief Add a header to a list set up with http_conn_headers_init().
+ *
+ * @param header Complete header line, including its CRLF.
+ *
+ * @retval 0 on success.
+ * @retval -ENOMEM if HTTP_CONN_HEADERS_MAX headers were added already.
+ */
+int http_conn_header_add(struct http_conn_headers *headers, const char *header);
+
+/**
+ * @brief Take the connection for sending requests without http_client_req().
+ *
+ * Opens a connection if none is open or the open one was closed by the server. The connection
+ * manager stays locked until http_conn_release() is called.
+ *
+ * @param reused Set to true if the connection was left open by an earlier request.
+ *
+ * @return Socket of the connection, or a negative error code.
+ */
+int http_conn_acquire(bool *reused);
+
+/**
+ * @brief Give back a connection taken with http_conn_acquire().
+ *
+ * @param keep_open False if the connection must not be reused, e.g. after an error or when the
+ *		    server asked to close it. Ignored when keep-alive is off.
+ */
+void http_conn_release(bool keep_open);
+
+/**
+ * @brief Turn connection reuse on or off at runtime, e.g. to compare both in a benchmark.
+ *
+ * Starts out as CONFIG_HTTP_SAMPLE_KEEPALIVE. Closes the open connection.
+ */
+void http_conn_keepalive_set(bool enable);
+
+/** @brief Close the connection, if open. */
+void http_conn_close(void);
+
+void http_conn_stats_get(struct http_conn_stats *stats);
+
+void http_conn_stats_log(void);
+
+#endif /* HTTP_CONN_H_ */
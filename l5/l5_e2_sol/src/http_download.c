@@ -0,0 +1,467 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/flash.h>
+#include <zephyr/storage/stream_flash.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/net/http/client.h>
+#include <zephyr/net/http/parser.h>
+#include <psa/crypto.h>
+
+#include "http_body.h"
+#include "http_conn.h"
+#include "http_download.h"
+
+LOG_MODULE_REGISTER(http_download, LOG_LEVEL_INF);
+
+#define SETTINGS_SUBTREE  "http_dl"
+#define SETTINGS_PROGRESS SETTINGS_SUBTREE "/progress"
+
+#define CHUNK_SIZE   CONFIG_HTTP_SAMPLE_DOWNLOAD_CHUNK_SIZE
+#define FLASH_OFFSET CONFIG_HTTP_SAMPLE_DOWNLOAD_FLASH_OFFSET
+#define FLASH_SIZE   CONFIG_HTTP_SAMPLE_DOWNLOAD_FLASH_SIZE
+
+#define MAX_ATTEMPTS 5
+#define RETRY_DELAY  K_SECONDS(2)
+
+/* A chunk fills the write buffer a whole number of times, so it is empty between chunks. */
+BUILD_ASSERT(CHUNK_SIZE % CONFIG_HTTP_SAMPLE_DOWNLOAD_WRITE_BUF_SIZE == 0,
+	     "Chunk size must be a multiple of the write buffer size");
+
+/* Stored in settings after every chunk. */
+struct download_progress {
+	/* CRC32 of the path, a different file starts over. */
+	uint32_t path_crc;
+	uint32_t offset;
+	/* Size of the file, 0 until the server has reported it. */
+	uint32_t total;
+};
+
+static const struct device *const flash_dev = DEVICE_DT_GET(DT_CHOSEN(nordic_pm_ext_flash));
+
+static struct download_progress progress;
+static struct stream_flash_ctx stream;
+static uint8_t write_buf[CONFIG_HTTP_SAMPLE_DOWNLOAD_WRITE_BUF_SIZE];
+static uint8_t recv_buf[CONFIG_HTTP_SAMPLE_DOWNLOAD_RECV_BUF_SIZE];
+
+static psa_hash_operation_t hash_op;
+/* Hash state at the start of the current chunk, restored when the chunk fails. */
+static psa_hash_operation_t chunk_hash_op;
+
+static char range_header[48];
+static const char *range_headers[] = {range_header, NULL};
+
+static bool content_range_field;
+static uint32_t reported_total;
+static uint32_t chunk_received;
+static int chunk_status;
+/* Status code of the chunk's response, 0 until one has been received. */
+static uint16_t chunk_code;
+
+static int download_settings_set(const char *name, size_t len, settings_read_cb read_cb,
+				 void *cb_arg)
+{
+	int ret;
+	const char *next;
+
+	if (!settings_name_steq(name, "progress", &next) || next) {
+		return -ENOENT;
+	}
+
+	if (len != sizeof(progress)) {
+		return -EINVAL;
+	}
+
+	ret = read_cb(cb_arg, &progress, len);
+	return ret < 0 ? ret : 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(http_dl, SETTINGS_SUBTREE, NULL, download_settings_set, NULL,
+			       NULL);
+
+static int on_header_field(struct http_parser *parser, const char *at, size_t length)
+{
+	content_range_field = length == strlen("Content-Range") &&
+			      strncasecmp(at, "Content-Range", length) == 0;
+	return 0;
+}
+
+static int on_header_value(struct http_parser *parser, const char *at, size_t length)
+{
+	const char *total;
+
+	if (!content_range_field) {
+		return 0;
+	}
+
+	/* bytes <first>-<last>/<total>, where total may be "*" if unknown. */
+	total = memchr(at, '/', length);
+	if (total && total + 1 < at + length && isdigit((unsigned char)total[1])) {
+		reported_total = strtoul(total + 1, NULL, 10);
+	}
+
+	return 0;
+}
+
+static const struct http_parser_settings header_cb = {
+	.on_header_field = on_header_field,
+	.on_header_value = on_header_value,
+};
+
+static int sink_begin(const struct http_response *rsp, void *ctx)
+{
+	chunk_code = rsp->http_status_code;
+
+	switch (rsp->http_status_code) {
+	case 206:
+		return 0;
+	case 200:
+		/* The server ignored the Range header and sends the whole file. */
+		if (progress.offset > 0) {
+			return -ENOTSUP;
+		}
+
+		reported_total = rsp->content_length;
+		return 0;
+	case 416:
+		/* Nothing left after the requested offset. */
+		return -ERANGE;
+	default:
+		LOG_ERR("Unexpected response status: %s", rsp->http_status);
+		return -EIO;
+	}
+}
+
+static int sink_write(size_t offset, const uint8_t *data, size_t len, void *ctx)
+{
+	int err;
+
+	err = stream_flash_buffered_write(&stream, data, len, false);
+	if (err) {
+		LOG_ERR("Flash write failed, err: %d", err);
+		return err;
+	}
+
+	(void)psa_hash_update(&hash_op, data, len);
+	chunk_received += len;
+
+	return 0;
+}
+
+static void sink_end(int status, void *ctx)
+{
+	chunk_status = status;
+}
+
+static const struct http_body_sink download_sink = {
+	.begin = sink_begin,
+	.write = sink_write,
+	.end = sink_end,
+};
+
+static int stream_init(void)
+{
+	return stream_flash_init(&stream, flash_dev, write_buf, sizeof(write_buf),
+				 FLASH_OFFSET + progress.offset, FLASH_SIZE - progress.offset, NULL);
+}
+
+static int progress_save(void)
+{
+	int err = settings_save_one(SETTINGS_PROGRESS, &progress, sizeof(progress));
+
+	if (err) {
+		LOG_WRN("Failed to store download progress, err: %d", err);
+	}
+
+	return err;
+}
+
+/* Hash the part of the file that is already in flash, to continue the hash from there. */
+static int hash_restart(void)
+{
+	psa_status_t status;
+	int err;
+	size_t len;
+
+	(void)psa_hash_abort(&hash_op);
+	hash_op = psa_hash_operation_init();
+
+	status = psa_hash_setup(&hash_op, PSA_ALG_SHA_256);
+	if (status != PSA_SUCCESS) {
+		LOG_ERR("Failed to set up SHA-256, status: %d", status);
+		return -EIO;
+	}
+
+	for (uint32_t pos = 0; pos < progress.offset; pos += len) {
+		len = MIN(sizeof(write_buf), progress.offset - pos);
+
+		err = flash_read(flash_dev, FLASH_OFFSET + pos, write_buf, len);
+		if (err) {
+			return err;
+		}
+
+		(void)psa_hash_update(&hash_op, write_buf, len);
+	}
+
+	return 0;
+}
+
+static int download_prepare(void)
+{
+	struct flash_pages_info page;
+	uint32_t path_crc = crc32_ieee(CONFIG_HTTP_SAMPLE_DOWNLOAD_PATH,
+				       strlen(CONFIG_HTTP_SAMPLE_DOWNLOAD_PATH));
+	int err;
+
+	if (!device_is_ready(flash_dev)) {
+		LOG_ERR("Flash device not ready");
+		return -ENODEV;
+	}
+
+	err = flash_get_page_info_by_offs(flash_dev, FLASH_OFFSET, &page);
+	if (err) {
+		return err;
+	}
+
+	/* Chunks must end on erase page boundaries, so that resuming never erases data. */
+	if (CHUNK_SIZE % page.size != 0 || FLASH_OFFSET % page.size != 0) {
+		LOG_ERR("Chunk size and flash offset must be multiples of the %d byte erase page",
+			page.size);
+		return -EINVAL;
+	}
+
+	if (progress.path_crc != path_crc || progress.offset > FLASH_SIZE) {
+		memset(&progress, 0, sizeof(progress));
+		progress.path_crc = path_crc;
+	}
+
+	progress.offset -= progress.offset % page.size;
+
+	err = hash_restart();
+	if (err) {
+		return err;
+	}
+
+	return stream_init();
+}
+
+static bool download_complete(void)
+{
+	return progress.total > 0 && progress.offset >= progress.total;
+}
+
+static int chunk_get(void)
+{
+	struct http_request req;
+	struct http_body body;
+	uint32_t last = progress.offset + CHUNK_SIZE - 1;
+	int ret;
+
+	if (progress.total > 0) {
+		last = MIN(last, progress.total - 1);
+	}
+
+	snprintk(range_header, sizeof(range_header), "Range: bytes=%u-%u\r\n", progress.offset,
+		 last);
+
+	memset(&req, 0, sizeof(req));
+	req.method = HTTP_GET;
+	req.url = CONFIG_HTTP_SAMPLE_DOWNLOAD_PATH;
+	req.host = CONFIG_HTTP_SAMPLE_HOSTNAME;
+	req.protocol = "HTTP/1.1";
+	req.optional_headers = range_headers;
+	req.http_cb = &header_cb;
+	req.response = http_body_response_cb;
+	req.recv_buf = recv_buf;
+	req.recv_buf_len = sizeof(recv_buf);
+
+	http_body_init(&body, &download_sink);
+	chunk_received = 0;
+	chunk_status = 0;
+	chunk_code = 0;
+	reported_total = 0;
+
+	(void)psa_hash_abort(&chunk_hash_op);
+	chunk_hash_op = psa_hash_operation_init();
+	(void)psa_hash_clone(&hash_op, &chunk_hash_op);
+
+	ret = http_conn_request(&req, CONFIG_HTTP_SAMPLE_DOWNLOAD_TIMEOUT_MS, &body);
+	if (ret < 0) {
+		/* Keeps the error of the sink if it aborted the request. */
+		http_body_abort(&body, ret);
+		return chunk_status ? chunk_status : ret;
+	}
+
+	if (chunk_status == 0 && chunk_code == 0) {
+		/* The connection closed before a response, which says nothing about the file. */
+		LOG_WRN("No response to the Range request");
+		return -EIO;
+	}
+
+	if (chunk_status == 0 && chunk_code == 206 && chunk_received < last - progress.offset + 1 &&
+	    reported_total == 0) {
+		/* A short chunk without a reported size is the end of the file. */
+		reported_total = progress.offset + chunk_received;
+	}
+
+	if (reported_total > FLASH_SIZE) {
+		LOG_ERR("File of %d bytes does not fit in %d bytes of flash", reported_total,
+			FLASH_SIZE);
+		return -EFBIG;
+	}
+
+	return chunk_status;
+}
+
+/* Drop what the failed chunk wrote and continue from the last stored offset. */
+static void chunk_rollback(void)
+{
+	(void)psa_hash_abort(&hash_op);
+	hash_op = psa_hash_operation_init();
+	(void)psa_hash_clone(&chunk_hash_op, &hash_op);
+	(void)stream_init();
+}
+
+static int chunk_commit(void)
+{
+	int err;
+
+	err = stream_flash_buffered_write(&stream, NULL, 0, true);
+	if (err) {
+		return err;
+	}
+
+	progress.offset += chunk_received;
+	if (reported_total > 0) {
+		progress.total = reported_total;
+	}
+
+	return progress_save();
+}
+
+static void hash_log(void)
+{
+	uint8_t hash[PSA_HASH_LENGTH(PSA_ALG_SHA_256)];
+	char hex[2 * sizeof(hash) + 1];
+	size_t len;
+
+	if (psa_hash_finish(&hash_op, hash, sizeof(hash), &len) != PSA_SUCCESS) {
+		LOG_ERR("Failed to compute SHA-256");
+		return;
+	}
+
+	for (size_t i = 0; i < len; i++) {
+		snprintk(&hex[2 * i], 3, "%02x", hash[i]);
+	}
+
+	LOG_INF("SHA-256: %s", hex);
+}
+
+int http_download_run(void)
+{
+	int err;
+	int attempts = 0;
+	uint32_t resumed_at;
+	int64_t start;
+	int64_t chunk_start;
+	uint32_t ms;
+
+	if (psa_crypto_init() != PSA_SUCCESS) {
+		return -EIO;
+	}
+
+	err = settings_subsys_init();
+	if (!err) {
+		err = settings_load_subtree(SETTINGS_SUBTREE);
+	}
+	if (err) {
+		LOG_WRN("Failed to load download progress, err: %d", err);
+	}
+
+	err = download_prepare();
+	if (err) {
+		LOG_ERR("Failed to prepare download, err: %d", err);
+		return err;
+	}
+
+	resumed_at = progress.offset;
+	if (resumed_at > 0) {
+		LOG_INF("Resuming %s at %d bytes", CONFIG_HTTP_SAMPLE_DOWNLOAD_PATH, resumed_at);
+	}
+
+	start = k_uptime_get();
+
+	while (!download_complete()) {
+		chunk_start = k_uptime_get();
+
+		err = chunk_get();
+		if (err == -ERANGE) {
+			/* The file ends at the stored offset. */
+			progress.total = progress.offset;
+			(void)progress_save();
+			break;
+		}
+
+		if (err == -EFBIG) {
+			return err;
+		}
+
+		if (err == -ENOTSUP) {
+			LOG_WRN("Server does not support Range requests, starting over");
+			memset(&progress, 0, sizeof(progress));
+			(void)download_prepare();
+			continue;
+		}
+
+		if (!err) {
+			err = chunk_commit();
+		}
+
+		if (err) {
+			chunk_rollback();
+
+			if (++attempts >= MAX_ATTEMPTS) {
+				LOG_ERR("Download failed at %d bytes, err: %d", progress.offset, err);
+				return err;
+			}
+
+			LOG_WRN("Chunk at %d failed, err: %d, retrying", progress.offset, err);
+			k_sleep(RETRY_DELAY);
+			continue;
+		}
+
+		attempts = 0;
+		ms = MAX((uint32_t)(k_uptime_get() - chunk_start), 1);
+		LOG_INF("%d of %d bytes, chunk at %d kbit/s", progress.offset, progress.total,
+			chunk_received * 8 / ms);
+
+		if (chunk_received == 0) {
+			/* An empty response to a range, nothing more is coming. The total stays 0 for
+			 * an empty file, so leave the loop here rather than through download_complete().
+			 */
+			progress.total = progress.offset;
+			(void)progress_save();
+			break;
+		}
+	}
+
+	ms = MAX((uint32_t)(k_uptime_get() - start), 1);
+	LOG_INF("Download complete: %d bytes, %d bytes in %d ms, %d kbit/s", progress.total,
+		progress.total - resumed_at, ms, (progress.total - resumed_at) * 8 / ms);
+	hash_log();
+
+	return 0;
+}
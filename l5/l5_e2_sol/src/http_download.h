@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef HTTP_DOWNLOAD_H_
+#define HTTP_DOWNLOAD_H_
+
+/**
+ * @brief Download CONFIG_HTTP_SAMPLE_DOWNLOAD_PATH into external flash.
+ *
+ * The file is fetched with Range requests of CONFIG_HTTP_SAMPLE_DOWNLOAD_CHUNK_SIZE bytes and
+ * streamed into flash at CONFIG_HTTP_SAMPLE_DOWNLOAD_FLASH_OFFSET while a SHA-256 hash is
+ * computed. The offset reached is stored in settings after every chunk, so an interrupted
+ * download continues from there, also after a reboot. A failed chunk is requested again from
+ * its start.
+ *
+ * Blocks until the download is complete or has failed too many times in a row.
+ *
+ * @return 0 when the whole file is in flash, or a negative error code.
+ */
+int http_download_run(void);
+
+#endif /* HTTP_DOWNLOAD_H_ */
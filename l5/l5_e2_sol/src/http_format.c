@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <stdarg.h>
+#include <string.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/net/http/client.h>
+#include <zephyr/net/http/parser.h>
+
+#include "http_format.h"
+
+static int append(char *buf, size_t size, int len, const char *fmt, ...)
+{
+	va_list args;
+	int ret;
+
+	if (len < 0) {
+		return len;
+	}
+
+	va_start(args, fmt);
+	ret = vsnprintk(buf + len, size - len, fmt, args);
+	va_end(args);
+
+	if (ret < 0 || (size_t)ret >= size - len) {
+		return -ENOMEM;
+	}
+
+	return len + ret;
+}
+
+int http_format_request(const struct http_request *req, bool keep_alive, char *buf, size_t size)
+{
+	int len;
+
+	len = append(buf, size, 0, "%s %s %s\r\nHost: %s\r\nConnection: %s\r\n",
+		     http_method_str(req->method), req->url, req->protocol, req->host,
+		     keep_alive ? "keep-alive" : "close");
+
+	for (size_t i = 0; req->header_fields && req->header_fields[i]; i++) {
+		len = append(buf, size, len, "%s", req->header_fields[i]);
+	}
+
+	for (size_t i = 0; req->optional_headers && req->optional_headers[i]; i++) {
+		len = append(buf, size, len, "%s", req->optional_headers[i]);
+	}
+
+	if (req->content_type_value) {
+		len = append(buf, size, len, "Content-Type: %s\r\n", req->content_type_value);
+	}
+
+	if (req->payload_len > 0) {
+		len = append(buf, size, len, "Content-Length: %zu\r\n", req->payload_len);
+	}
+
+	len = append(buf, size, len, "\r\n");
+	if (len < 0 || req->payload_len > size - len) {
+		return -ENOMEM;
+	}
+
+	if (req->payload_len > 0) {
+		memcpy(buf + len, req->payload, req->payload_len);
+	}
+
+	return len + req->payload_len;
+}
+
+static void deliver(struct http_format_parser *fp, enum http_final_call final_data)
+{
+	struct http_response *rsp = fp->rsp;
+
+	rsp->recv_buf = fp->buf;
+	rsp->recv_buf_len = fp->buf_size;
+	rsp->data_len = fp->len;
+
+	if (fp->req->response) {
+		(void)fp->req->response(rsp, final_data, fp->user_data);
+	}
+
+	rsp->body_frag_start = NULL;
+	rsp->body_frag_len = 0;
+}
+
+static int on_message_begin(struct http_parser *p)
+{
+	struct http_format_parser *fp = CONTAINER_OF(p, struct http_format_parser, parser);
+	const struct http_parser_settings *cb;
+
+	if (fp->message_begin && fp->message_begin(fp)) {
+		return -1;
+	}
+
+	memset(fp->rsp, 0, sizeof(*fp->rsp));
+
+	cb = fp->req->http_cb;
+	return (cb && cb->on_message_begin) ? cb->on_message_begin(p) : 0;
+}
+
+static int on_status(struct http_parser *p, const char *at, size_t length)
+{
+	struct http_response *rsp = CONTAINER_OF(p, struct http_format_parser, parser)->rsp;
+	size_t used = strlen(rsp->http_status);
+	size_t n = MIN(length, sizeof(rsp->http_status) - 1 - used);
+
+	memcpy(rsp->http_status + used, at, n);
+	rsp->http_status[used + n] = '\0';
+	rsp->http_status_code = p->status_code;
+
+	return 0;
+}
+
+static int on_header_field(struct http_parser *p, const char *at, size_t length)
+{
+	const struct http_parser_settings *cb =
+		CONTAINER_OF(p, struct http_format_parser, parser)->req->http_cb;
+
+	return (cb && cb->on_header_field) ? cb->on_header_field(p, at, length) : 0;
+}
+
+static int on_header_value(struct http_parser *p, const char *at, size_t length)
+{
+	const struct http_parser_settings *cb =
+		CONTAINER_OF(p, struct http_format_parser, parser)->req->http_cb;
+
+	return (cb && cb->on_header_value) ? cb->on_header_value(p, at, length) : 0;
+}
+
+static int on_headers_complete(struct http_parser *p)
+{
+	struct http_response *rsp = CONTAINER_OF(p, struct http_format_parser, parser)->rsp;
+
+	rsp->http_status_code = p->status_code;
+	rsp->content_length = p->content_length;
+
+	return 0;
+}
+
+static int on_body(struct http_parser *p, const char *at, size_t length)
+{
+	struct http_response *rsp = CONTAINER_OF(p, struct http_format_parser, parser)->rsp;
+
+	/* Body data seen in one call of http_parser_execute() is contiguous in the buffer. */
+	if (!rsp->body_frag_start) {
+		rsp->body_frag_start = (uint8_t *)at;
+	}
+
+	rsp->body_frag_len += length;
+	rsp->processed += length;
+	rsp->body_found = 1;
+
+	return 0;
+}
+
+static int on_message_complete(struct http_parser *p)
+{
+	struct http_format_parser *fp = CONTAINER_OF(p, struct http_format_parser, parser);
+
+	fp->rsp->message_complete = 1;
+	deliver(fp, HTTP_DATA_FINAL);
+
+	if (fp->message_complete) {
+		fp->message_complete(fp);
+	}
+
+	return 0;
+}
+
+static const struct http_parser_settings parser_settings = {
+	.on_message_begin = on_message_begin,
+	.on_status = on_status,
+	.on_header_field = on_header_field,
+	.on_header_value = on_header_value,
+	.on_headers_complete = on_headers_complete,
+	.on_body = on_body,
+	.on_message_complete = on_message_complete,
+};
+
+void http_format_parser_init(struct http_format_parser *fp, uint8_t *buf, size_t buf_size)
+{
+	memset(fp, 0, sizeof(*fp));
+	http_parser_init(&fp->parser, HTTP_RESPONSE);
+	fp->buf = buf;
+	fp->buf_size = buf_size;
+}
+
+int http_format_parse(struct http_format_parser *fp, size_t len)
+{
+	fp->len = len;
+	(void)http_parser_execute(&fp->parser, &parser_settings, (const char *)fp->buf, len);
+
+	if (HTTP_PARSER_ERRNO(&fp->parser) != HPE_OK) {
+		return -EBADMSG;
+	}
+
+	/* The rest of a body that did not end in this buffer */
+	if (fp->rsp && fp->rsp->body_frag_len > 0) {
+		deliver(fp, HTTP_DATA_MORE);
+	}
+
+	return 0;
+}
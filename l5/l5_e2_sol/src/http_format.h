@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef HTTP_FORMAT_H_
+#define HTTP_FORMAT_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/net/http/client.h>
+#include <zephyr/net/http/parser.h>
+
+/**
+ * @brief Write a request, headers and payload included, to a buffer.
+ *
+ * For modules that send requests themselves instead of through http_client_req(). The header
+ * fields, optional headers, content type and payload of the request are used. A payload
+ * callback is not.
+ *
+ * @param keep_alive Send Connection: keep-alive instead of Connection: close.
+ *
+ * @return Length of the request, or -ENOMEM if it does not fit in the buffer.
+ */
+int http_format_request(const struct http_request *req, bool keep_alive, char *buf, size_t size);
+
+/**
+ * @brief Parser of responses to requests sent with http_format_request().
+ *
+ * Fills in the struct http_response of the request like http_client_req() does, and passes body
+ * parts and the end of the response to the request's response callback. Message begin, header
+ * field and header value callbacks are passed on to the request's http_cb, if any.
+ */
+struct http_format_parser {
+	struct http_parser parser;
+	/* Request that the response being parsed answers, with its response and user data. */
+	const struct http_request *req;
+	struct http_response *rsp;
+	void *user_data;
+	/* Buffer the received data is parsed from. */
+	uint8_t *buf;
+	size_t buf_size;
+	size_t len;
+	/* Optional. Called when a response begins, e.g. to point req, rsp and user_data at the
+	 * request it answers. A nonzero return stops the parser.
+	 */
+	int (*message_begin)(struct http_format_parser *fp);
+	/* Optional. Called once the end of a response has been delivered. */
+	void (*message_complete)(struct http_format_parser *fp);
+};
+
+/**
+ * @brief Start parsing a new stream of responses received into @p buf.
+ *
+ * Clears the request, response and callbacks, set them afterwards.
+ */
+void http_format_parser_init(struct http_format_parser *fp, uint8_t *buf, size_t buf_size);
+
+/**
+ * @brief Parse @p len bytes received into the buffer of the parser.
+ *
+ * Zero bytes tell the parser that the server closed the connection, which ends a body without a
+ * length.
+ *
+ * @retval 0 on success.
+ * @retval -EBADMSG if the parser stopped, see HTTP_PARSER_ERRNO() for the reason.
+ */
+int http_format_parse(struct http_format_parser *fp, size_t len);
+
+#endif /* HTTP_FORMAT_H_ */
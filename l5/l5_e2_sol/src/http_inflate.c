@@ -0,0 +1,889 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <strings.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/net/http/client.h>
+#include <zephyr/net/http/parser.h>
+
+#include "http_inflate.h"
+
+LOG_MODULE_REGISTER(http_inflate, LOG_LEVEL_INF);
+
+#define WINDOW_SIZE CONFIG_HTTP_SAMPLE_INFLATE_WINDOW_SIZE
+/* Large enough for the biggest step that is decoded in one go, a dynamic block header. */
+#define IN_BUF_SIZE 1024
+
+#define MAX_BITS     15
+#define MAX_LCODES   286
+#define MAX_DCODES   30
+#define FIXED_LCODES 288
+
+#define ADLER_BASE 65521
+#define ADLER_NMAX 5552
+
+#define GZIP_FHCRC    0x02
+#define GZIP_FEXTRA   0x04
+#define GZIP_FNAME    0x08
+#define GZIP_FCOMMENT 0x10
+
+enum wrapper {
+	WRAPPER_NONE,
+	WRAPPER_GZIP,
+	/* zlib stream, or raw deflate from servers that send Content-Encoding: deflate without it. */
+	WRAPPER_DEFLATE,
+	WRAPPER_ZLIB,
+	WRAPPER_RAW,
+};
+
+enum state {
+	STATE_HEADER,
+	STATE_BLOCK,
+	STATE_CODES,
+	STATE_STORED,
+	STATE_TRAILER,
+	STATE_DONE,
+};
+
+/* Canonical Huffman code: number of codes of each length and the symbols ordered by code. */
+struct huffman {
+	uint16_t count[MAX_BITS + 1];
+	uint16_t symbol[FIXED_LCODES];
+};
+
+static const uint16_t len_base[29] = {3,  4,  5,  6,  7,  8,  9,  10,  11,  13,
+				      15, 17, 19, 23, 27, 31, 35, 43,  51,  59,
+				      67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const uint8_t len_extra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+				      2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const uint16_t dist_base[30] = {1,    2,    3,    4,    5,    7,     9,     13,
+				       17,   25,   33,   49,   65,   97,    129,   193,
+				       257,  385,  513,  769,  1025, 1537,  2049,  3073,
+				       4097, 6145, 8193, 12289, 16385, 24577};
+static const uint8_t dist_extra[30] = {0, 0, 0, 0, 1, 1, 2,  2,  3,  3,  4,  4,  5,  5,  6,
+				       6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+/* Order in which the code length code lengths are sent in a dynamic block header. */
+static const uint8_t cl_order[19] = {16, 17, 18, 0, 8,  7, 9,  6, 10, 5,
+				     11, 4,  12, 3, 13, 2, 14, 1, 15};
+
+static struct huffman fixed_lencode;
+static struct huffman fixed_distcode;
+static bool fixed_ready;
+
+/* Decoder state of the body in flight. */
+static struct {
+	enum wrapper wrapper;
+	enum state state;
+	bool last_block;
+	uint32_t stored_left;
+
+	uint8_t in[IN_BUF_SIZE];
+	size_t in_len;
+	size_t in_pos;
+	uint32_t bitbuf;
+	int bitcnt;
+
+	struct huffman lencode;
+	struct huffman distcode;
+	const struct huffman *lc;
+	const struct huffman *dc;
+
+	uint8_t window[WINDOW_SIZE];
+	size_t win_pos;
+	size_t win_flushed;
+	uint32_t total_out;
+	uint32_t total_in;
+
+	uint32_t crc;
+	uint32_t adler_a;
+	uint32_t adler_b;
+
+	int sink_err;
+	uint32_t sink_cycles;
+	uint32_t decode_cycles;
+} inf;
+
+static const struct http_body_sink *next_sink;
+static const struct http_parser_settings *next_cb;
+static char content_encoding[16];
+static bool encoding_field;
+
+static struct http_inflate_stats stats;
+static K_MUTEX_DEFINE(stats_lock);
+
+static const char accept_header[] = "Accept-Encoding: gzip, deflate\r\n";
+
+/* Take need bits, least significant first. Returns -EAGAIN if the input runs out first. */
+static int bits(int need)
+{
+	uint32_t val = inf.bitbuf;
+
+	while (inf.bitcnt < need) {
+		if (inf.in_pos == inf.in_len) {
+			return -EAGAIN;
+		}
+
+		val |= (uint32_t)inf.in[inf.in_pos++] << inf.bitcnt;
+		inf.bitcnt += 8;
+	}
+
+	inf.bitbuf = val >> need;
+	inf.bitcnt -= need;
+
+	return val & ((1U << need) - 1);
+}
+
+static int decode(const struct huffman *h)
+{
+	int bit;
+	int code = 0;
+	int first = 0;
+	int index = 0;
+
+	for (int len = 1; len <= MAX_BITS; len++) {
+		bit = bits(1);
+		if (bit < 0) {
+			return bit;
+		}
+
+		code |= bit;
+		if (code - h->count[len] < first) {
+			return h->symbol[index + (code - first)];
+		}
+
+		index += h->count[len];
+		first += h->count[len];
+		first <<= 1;
+		code <<= 1;
+	}
+
+	return -EBADMSG;
+}
+
+/* Returns 0 for a complete code, > 0 for an incomplete one and < 0 if it is over-subscribed. */
+static int construct(struct huffman *h, const uint8_t *length, int n)
+{
+	uint16_t offs[MAX_BITS + 1];
+	int left = 1;
+
+	memset(h->count, 0, sizeof(h->count));
+	for (int sym = 0; sym < n; sym++) {
+		h->count[length[sym]]++;
+	}
+
+	if (h->count[0] == n) {
+		return 0;
+	}
+
+	for (int len = 1; len <= MAX_BITS; len++) {
+		left <<= 1;
+		left -= h->count[len];
+		if (left < 0) {
+			return left;
+		}
+	}
+
+	offs[1] = 0;
+	for (int len = 1; len < MAX_BITS; len++) {
+		offs[len + 1] = offs[len] + h->count[len];
+	}
+
+	for (int sym = 0; sym < n; sym++) {
+		if (length[sym] != 0) {
+			h->symbol[offs[length[sym]]++] = sym;
+		}
+	}
+
+	return left;
+}
+
+static void fixed_init(void)
+{
+	uint8_t lengths[FIXED_LCODES];
+
+	if (fixed_ready) {
+		return;
+	}
+
+	memset(lengths, 8, 144);
+	memset(lengths + 144, 9, 112);
+	memset(lengths + 256, 7, 24);
+	memset(lengths + 280, 8, 8);
+	(void)construct(&fixed_lencode, lengths, FIXED_LCODES);
+
+	memset(lengths, 5, MAX_DCODES);
+	(void)construct(&fixed_distcode, lengths, MAX_DCODES);
+
+	fixed_ready = true;
+}
+
+static void checksum_update(const uint8_t *data, size_t len)
+{
+	size_t n;
+
+	if (inf.wrapper == WRAPPER_GZIP) {
+		inf.crc = crc32_ieee_update(inf.crc, data, len);
+		return;
+	} else if (inf.wrapper != WRAPPER_ZLIB) {
+		return;
+	}
+
+	/* Adler-32, reduced every ADLER_NMAX bytes, the most before the sums can overflow. */
+	while (len > 0) {
+		n = MIN(len, ADLER_NMAX);
+		len -= n;
+
+		while (n-- > 0) {
+			inf.adler_a += *data++;
+			inf.adler_b += inf.adler_a;
+		}
+
+		inf.adler_a %= ADLER_BASE;
+		inf.adler_b %= ADLER_BASE;
+	}
+}
+
+/* Pass the output not yet passed on to the next sink. */
+static void flush(void)
+{
+	size_t len = inf.win_pos - inf.win_flushed;
+	const uint8_t *data = inf.window + inf.win_flushed;
+	uint32_t start;
+	int err;
+
+	if (len == 0 || inf.sink_err) {
+		return;
+	}
+
+	checksum_update(data, len);
+
+	start = k_cycle_get_32();
+	err = next_sink->write(inf.total_out - len, data, len, next_sink->ctx);
+	inf.sink_cycles += k_cycle_get_32() - start;
+
+	inf.win_flushed = inf.win_pos;
+	if (err < 0) {
+		inf.sink_err = err;
+	}
+}
+
+static void out_byte(uint8_t byte)
+{
+	inf.window[inf.win_pos++] = byte;
+	inf.total_out++;
+
+	/* The window keeps its contents after it wraps, for back-references. */
+	if (inf.win_pos == WINDOW_SIZE) {
+		flush();
+		inf.win_pos = 0;
+		inf.win_flushed = 0;
+	}
+}
+
+static int gzip_header(void)
+{
+	const uint8_t *p = inf.in + inf.in_pos;
+	size_t avail = inf.in_len - inf.in_pos;
+	size_t pos = 10;
+	uint8_t flags;
+
+	if (avail < pos) {
+		return -EAGAIN;
+	}
+
+	if (p[0] != 0x1f || p[1] != 0x8b || p[2] != 8) {
+		LOG_ERR("Not a gzip stream");
+		return -EBADMSG;
+	}
+
+	flags = p[3];
+
+	if (flags & GZIP_FEXTRA) {
+		if (avail < pos + 2) {
+			return -EAGAIN;
+		}
+		pos += 2 + (p[pos] | (p[pos + 1] << 8));
+	}
+
+	for (uint8_t field = GZIP_FNAME; field <= GZIP_FCOMMENT; field <<= 1) {
+		if (!(flags & field)) {
+			continue;
+		}
+
+		/* Zero-terminated file name or comment. */
+		do {
+			if (avail <= pos) {
+				return -EAGAIN;
+			}
+		} while (p[pos++] != 0);
+	}
+
+	if (flags & GZIP_FHCRC) {
+		pos += 2;
+	}
+
+	if (avail < pos) {
+		return -EAGAIN;
+	}
+
+	inf.in_pos += pos;
+	return 0;
+}
+
+static int wrapper_header(void)
+{
+	const uint8_t *p = inf.in + inf.in_pos;
+	int ret = 0;
+
+	if (inf.wrapper == WRAPPER_GZIP) {
+		ret = gzip_header();
+	} else if (inf.wrapper == WRAPPER_DEFLATE) {
+		if (inf.in_len - inf.in_pos < 2) {
+			return -EAGAIN;
+		}
+
+		if ((p[0] & 0x0f) == 8 && ((p[0] << 8) | p[1]) % 31 == 0) {
+			if (p[1] & 0x20) {
+				LOG_ERR("zlib stream with a preset dictionary");
+				return -ENOTSUP;
+			}
+
+			inf.wrapper = WRAPPER_ZLIB;
+			inf.in_pos += 2;
+		} else {
+			inf.wrapper = WRAPPER_RAW;
+		}
+	}
+
+	if (ret == 0) {
+		inf.state = STATE_BLOCK;
+	}
+
+	return ret;
+}
+
+static int dynamic_tables(void)
+{
+	uint8_t lengths[MAX_LCODES + MAX_DCODES];
+	int nlen;
+	int ndist;
+	int ncode;
+	int index;
+	int symbol;
+	int len;
+	int ret;
+
+	nlen = bits(5);
+	ndist = bits(5);
+	ncode = bits(4);
+	if (nlen < 0 || ndist < 0 || ncode < 0) {
+		return -EAGAIN;
+	}
+
+	nlen += 257;
+	ndist += 1;
+	ncode += 4;
+	if (nlen > MAX_LCODES || ndist > MAX_DCODES) {
+		return -EBADMSG;
+	}
+
+	memset(lengths, 0, 19);
+	for (index = 0; index < ncode; index++) {
+		ret = bits(3);
+		if (ret < 0) {
+			return ret;
+		}
+		lengths[cl_order[index]] = ret;
+	}
+
+	if (construct(&inf.lencode, lengths, 19) != 0) {
+		return -EBADMSG;
+	}
+
+	index = 0;
+	while (index < nlen + ndist) {
+		symbol = decode(&inf.lencode);
+		if (symbol < 0) {
+			return symbol;
+		}
+
+		if (symbol < 16) {
+			lengths[index++] = symbol;
+			continue;
+		}
+
+		len = 0;
+		if (symbol == 16) {
+			if (index == 0) {
+				return -EBADMSG;
+			}
+			len = lengths[index - 1];
+			ret = bits(2);
+			symbol = 3 + ret;
+		} else if (symbol == 17) {
+			ret = bits(3);
+			symbol = 3 + ret;
+		} else {
+			ret = bits(7);
+			symbol = 11 + ret;
+		}
+
+		if (ret < 0) {
+			return ret;
+		}
+
+		if (index + symbol > nlen + ndist) {
+			return -EBADMSG;
+		}
+
+		memset(lengths + index, len, symbol);
+		index += symbol;
+	}
+
+	if (lengths[256] == 0) {
+		return -EBADMSG;
+	}
+
+	/* Incomplete codes are only allowed for a single length. */
+	ret = construct(&inf.lencode, lengths, nlen);
+	if (ret < 0 || (ret > 0 && nlen - inf.lencode.count[0] != 1)) {
+		return -EBADMSG;
+	}
+
+	ret = construct(&inf.distcode, lengths + nlen, ndist);
+	if (ret < 0 || (ret > 0 && ndist - inf.distcode.count[0] != 1)) {
+		return -EBADMSG;
+	}
+
+	inf.lc = &inf.lencode;
+	inf.dc = &inf.distcode;
+	return 0;
+}
+
+static int block_header(void)
+{
+	const uint8_t *p;
+	int ret = bits(3);
+
+	if (ret < 0) {
+		return ret;
+	}
+
+	inf.last_block = ret & 1;
+
+	switch (ret >> 1) {
+	case 0:
+		/* Stored block, aligned to the next byte. */
+		inf.bitbuf = 0;
+		inf.bitcnt = 0;
+
+		if (inf.in_len - inf.in_pos < 4) {
+			return -EAGAIN;
+		}
+
+		p = inf.in + inf.in_pos;
+		if ((p[0] | (p[1] << 8)) != (~(p[2] | (p[3] << 8)) & 0xffff)) {
+			return -EBADMSG;
+		}
+
+		inf.stored_left = p[0] | (p[1] << 8);
+		inf.in_pos += 4;
+		inf.state = STATE_STORED;
+		return 0;
+	case 1:
+		fixed_init();
+		inf.lc = &fixed_lencode;
+		inf.dc = &fixed_distcode;
+		break;
+	case 2:
+		ret = dynamic_tables();
+		if (ret < 0) {
+			return ret;
+		}
+		break;
+	default:
+		return -EBADMSG;
+	}
+
+	inf.state = STATE_CODES;
+	return 0;
+}
+
+static int stored_copy(void)
+{
+	size_t n = MIN(inf.stored_left, inf.in_len - inf.in_pos);
+
+	if (inf.stored_left > 0 && n == 0) {
+		return -EAGAIN;
+	}
+
+	for (size_t i = 0; i < n; i++) {
+		out_byte(inf.in[inf.in_pos++]);
+	}
+
+	inf.stored_left -= n;
+	if (inf.stored_left == 0) {
+		inf.state = inf.last_block ? STATE_TRAILER : STATE_BLOCK;
+	}
+
+	return 0;
+}
+
+/* Decode one literal, or one length and distance pair. */
+static int codes_step(void)
+{
+	int symbol;
+	int ret;
+	size_t len;
+	size_t dist;
+
+	symbol = decode(inf.lc);
+	if (symbol < 0) {
+		return symbol;
+	}
+
+	if (symbol < 256) {
+		out_byte(symbol);
+		return 0;
+	}
+
+	if (symbol == 256) {
+		inf.state = inf.last_block ? STATE_TRAILER : STATE_BLOCK;
+		return 0;
+	}
+
+	symbol -= 257;
+	if ((size_t)symbol >= ARRAY_SIZE(len_base)) {
+		return -EBADMSG;
+	}
+
+	ret = bits(len_extra[symbol]);
+	if (ret < 0) {
+		return ret;
+	}
+	len = len_base[symbol] + ret;
+
+	symbol = decode(inf.dc);
+	if (symbol < 0) {
+		return symbol;
+	}
+
+	if ((size_t)symbol >= ARRAY_SIZE(dist_base)) {
+		return -EBADMSG;
+	}
+
+	ret = bits(dist_extra[symbol]);
+	if (ret < 0) {
+		return ret;
+	}
+	dist = dist_base[symbol] + ret;
+
+	if (dist > inf.total_out) {
+		return -EBADMSG;
+	}
+
+	if (dist > WINDOW_SIZE) {
+		LOG_ERR("Distance %zu does not fit in the %d byte window", dist, WINDOW_SIZE);
+		return -EMSGSIZE;
+	}
+
+	while (len-- > 0) {
+		out_byte(inf.window[(inf.win_pos + WINDOW_SIZE - dist) % WINDOW_SIZE]);
+	}
+
+	return 0;
+}
+
+static uint32_t le32(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static int trailer(void)
+{
+	const uint8_t *p = inf.in + inf.in_pos;
+	size_t avail = inf.in_len - inf.in_pos;
+	uint32_t adler;
+
+	/* The trailer starts at the next byte. */
+	inf.bitbuf = 0;
+	inf.bitcnt = 0;
+
+	if (inf.wrapper == WRAPPER_GZIP) {
+		if (avail < 8) {
+			return -EAGAIN;
+		}
+
+		flush();
+		if (le32(p) != inf.crc || le32(p + 4) != inf.total_out) {
+			LOG_ERR("gzip CRC32 or length mismatch");
+			return -EBADMSG;
+		}
+
+		inf.in_pos += 8;
+	} else if (inf.wrapper == WRAPPER_ZLIB) {
+		if (avail < 4) {
+			return -EAGAIN;
+		}
+
+		flush();
+		adler = (inf.adler_b << 16) | inf.adler_a;
+		if (((uint32_t)p[0] << 24 | p[1] << 16 | p[2] << 8 | p[3]) != adler) {
+			LOG_ERR("zlib Adler-32 mismatch");
+			return -EBADMSG;
+		}
+
+		inf.in_pos += 4;
+	}
+
+	inf.state = STATE_DONE;
+	return 0;
+}
+
+/* Decode as much of the buffered input as possible. */
+static int inflate_run(void)
+{
+	size_t in_pos;
+	uint32_t bitbuf;
+	int bitcnt;
+	int ret;
+
+	while (inf.state != STATE_DONE && inf.sink_err == 0) {
+		/* Each step either completes or is undone and retried when more input is in. */
+		in_pos = inf.in_pos;
+		bitbuf = inf.bitbuf;
+		bitcnt = inf.bitcnt;
+
+		switch (inf.state) {
+		case STATE_HEADER:
+			ret = wrapper_header();
+			break;
+		case STATE_BLOCK:
+			ret = block_header();
+			break;
+		case STATE_CODES:
+			ret = codes_step();
+			break;
+		case STATE_STORED:
+			ret = stored_copy();
+			break;
+		default:
+			ret = trailer();
+			break;
+		}
+
+		if (ret == -EAGAIN) {
+			inf.in_pos = in_pos;
+			inf.bitbuf = bitbuf;
+			inf.bitcnt = bitcnt;
+		}
+
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return inf.sink_err;
+}
+
+static int inflate_feed(const uint8_t *data, size_t len)
+{
+	size_t n;
+	int ret;
+
+	while (len > 0 && inf.state != STATE_DONE) {
+		memmove(inf.in, inf.in + inf.in_pos, inf.in_len - inf.in_pos);
+		inf.in_len -= inf.in_pos;
+		inf.in_pos = 0;
+
+		n = MIN(len, sizeof(inf.in) - inf.in_len);
+		memcpy(inf.in + inf.in_len, data, n);
+		inf.in_len += n;
+		data += n;
+		len -= n;
+
+		ret = inflate_run();
+		if (ret == -EAGAIN && inf.in_pos == 0 && inf.in_len == sizeof(inf.in)) {
+			return -EMSGSIZE;
+		} else if (ret != -EAGAIN && ret < 0) {
+			return ret;
+		}
+	}
+
+	flush();
+	return inf.sink_err;
+}
+
+static void inflate_reset(void)
+{
+	inf.wrapper = WRAPPER_NONE;
+	inf.state = STATE_HEADER;
+	inf.last_block = false;
+	inf.stored_left = 0;
+	inf.in_len = 0;
+	inf.in_pos = 0;
+	inf.bitbuf = 0;
+	inf.bitcnt = 0;
+	inf.win_pos = 0;
+	inf.win_flushed = 0;
+	inf.total_out = 0;
+	inf.total_in = 0;
+	inf.crc = 0;
+	inf.adler_a = 1;
+	inf.adler_b = 0;
+	inf.sink_err = 0;
+	inf.sink_cycles = 0;
+	inf.decode_cycles = 0;
+}
+
+static int on_message_begin(struct http_parser *parser)
+{
+	/* A pipelined response without Content-Encoding must not take that of the previous one. */
+	content_encoding[0] = '\0';
+	encoding_field = false;
+
+	return (next_cb && next_cb->on_message_begin) ? next_cb->on_message_begin(parser) : 0;
+}
+
+static int on_header_field(struct http_parser *parser, const char *at, size_t length)
+{
+	encoding_field = length == strlen("Content-Encoding") &&
+			 strncasecmp(at, "Content-Encoding", length) == 0;
+
+	return (next_cb && next_cb->on_header_field) ? next_cb->on_header_field(parser, at, length)
+						     : 0;
+}
+
+static int on_header_value(struct http_parser *parser, const char *at, size_t length)
+{
+	if (encoding_field) {
+		snprintk(content_encoding, sizeof(content_encoding), "%.*s", (int)length, at);
+	}
+
+	return (next_cb && next_cb->on_header_value) ? next_cb->on_header_value(parser, at, length)
+						     : 0;
+}
+
+static const struct http_parser_settings header_cb = {
+	.on_message_begin = on_message_begin,
+	.on_header_field = on_header_field,
+	.on_header_value = on_header_value,
+};
+
+void http_inflate_request_prepare(struct http_request *req, struct http_conn_headers *headers,
+				  const struct http_body_sink *sink)
+{
+	next_sink = sink;
+	next_cb = req->http_cb;
+
+	if (http_conn_header_add(headers, accept_header)) {
+		LOG_WRN("No room for Accept-Encoding, the response is not compressed");
+	}
+
+	req->http_cb = &header_cb;
+}
+
+static int inflate_begin(const struct http_response *rsp, void *ctx)
+{
+	inflate_reset();
+
+	/* A 304 has no body, even if it names the encoding of the cached one. */
+	if (rsp->http_status_code == 304 || content_encoding[0] == '\0' ||
+	    strcasecmp(content_encoding, "identity") == 0) {
+		inf.wrapper = WRAPPER_NONE;
+	} else if (strcasecmp(content_encoding, "gzip") == 0 ||
+		   strcasecmp(content_encoding, "x-gzip") == 0) {
+		inf.wrapper = WRAPPER_GZIP;
+	} else if (strcasecmp(content_encoding, "deflate") == 0) {
+		inf.wrapper = WRAPPER_DEFLATE;
+	} else {
+		LOG_ERR("Unsupported content encoding: %s", content_encoding);
+		return -ENOTSUP;
+	}
+
+	return next_sink->begin ? next_sink->begin(rsp, next_sink->ctx) : 0;
+}
+
+static int inflate_write(size_t offset, const uint8_t *data, size_t len, void *ctx)
+{
+	uint32_t start;
+	int ret;
+
+	if (inf.wrapper == WRAPPER_NONE) {
+		return next_sink->write(offset, data, len, next_sink->ctx);
+	}
+
+	start = k_cycle_get_32();
+	ret = inflate_feed(data, len);
+	inf.decode_cycles += k_cycle_get_32() - start;
+	inf.total_in += len;
+
+	if (ret < 0 && ret != inf.sink_err) {
+		LOG_ERR("Failed to decode body at byte %zu, err: %d", offset, ret);
+	}
+
+	return ret;
+}
+
+static void inflate_end(int status, void *ctx)
+{
+	uint32_t decode_us;
+
+	if (inf.wrapper != WRAPPER_NONE) {
+		if (status == 0 && inf.state != STATE_DONE) {
+			LOG_ERR("Compressed body ended early");
+			status = -EBADMSG;
+		}
+
+		decode_us = k_cyc_to_us_floor32(inf.decode_cycles - inf.sink_cycles);
+
+		k_mutex_lock(&stats_lock, K_FOREVER);
+		stats.bodies++;
+		stats.errors += status < 0;
+		stats.compressed_bytes += inf.total_in;
+		stats.decompressed_bytes += inf.total_out;
+		stats.decode_us += decode_us;
+		k_mutex_unlock(&stats_lock);
+
+		LOG_INF("%s body: %d bytes compressed, %d bytes decoded, %d us to decode",
+			content_encoding, inf.total_in, inf.total_out, decode_us);
+	}
+
+	if (next_sink->end) {
+		next_sink->end(status, next_sink->ctx);
+	}
+}
+
+const struct http_body_sink http_inflate_sink = {
+	.begin = inflate_begin,
+	.write = inflate_write,
+	.end = inflate_end,
+};
+
+void http_inflate_stats_get(struct http_inflate_stats *out)
+{
+	k_mutex_lock(&stats_lock, K_FOREVER);
+	*out = stats;
+	k_mutex_unlock(&stats_lock);
+}
+
+void http_inflate_stats_log(void)
+{
+	struct http_inflate_stats s;
+
+	http_inflate_stats_get(&s);
+
+	LOG_INF("%d compressed bodies, %d failed to decode", s.bodies, s.errors);
+	LOG_INF("%d bytes received, %d bytes decoded, %d%% saved", s.compressed_bytes,
+		s.decompressed_bytes,
+		s.decompressed_bytes ? 100 - (int)(s.compressed_bytes * 100 / s.decompressed_bytes) : 0);
+	LOG_INF("Decode time: %d us total", s.decode_us);
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef HTTP_INFLATE_H_
+#define HTTP_INFLATE_H_
+
+#include <stdint.h>
+#include <zephyr/net/http/client.h>
+
+#include "http_body.h"
+#include "http_conn.h"
+
+/** @brief Counters kept by the response decoder. */
+struct http_inflate_stats {
+	/* Compressed bodies decoded, and bodies that failed to decode. */
+	uint32_t bodies;
+	uint32_t errors;
+	uint32_t compressed_bytes;
+	uint32_t decompressed_bytes;
+	/* CPU time spent decoding, not counting the time spent in the next sink. */
+	uint32_t decode_us;
+};
+
+/**
+ * @brief Ask for a compressed response and decode it on the fly.
+ *
+ * Adds Accept-Encoding: gzip, deflate to @p headers, which must be the optional headers of the
+ * request set up with http_conn_headers_init(), and collects the Content-Encoding of the response
+ * through the request's http_cb. An http_cb set before, e.g. by http_cache_request_prepare(),
+ * still receives all header callbacks.
+ *
+ * Send the request with a struct http_body initialized with http_inflate_sink. The decoded body is
+ * passed on to @p sink. Several requests prepared this way can be in flight at a time, e.g. when
+ * pipelined, as long as they are for the same sink.
+ */
+void http_inflate_request_prepare(struct http_request *req, struct http_conn_headers *headers,
+				  const struct http_body_sink *sink);
+
+/**
+ * @brief Sink that decodes gzip and deflate bodies and passes others on unchanged.
+ *
+ * Back-references are resolved in a window of CONFIG_HTTP_SAMPLE_INFLATE_WINDOW_SIZE bytes. A
+ * body that refers further back fails with -EMSGSIZE.
+ */
+extern const struct http_body_sink http_inflate_sink;
+
+void http_inflate_stats_get(struct http_inflate_stats *stats);
+
+void http_inflate_stats_log(void);
+
+#endif /* HTTP_INFLATE_H_ */
@@ -0,0 +1,331 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/http/client.h>
+#include <zephyr/net/http/parser.h>
+
+#include "http_conn.h"
+#include "http_format.h"
+#include "http_multi.h"
+
+LOG_MODULE_REGISTER(http_multi, LOG_LEVEL_INF);
+
+#define CONNS	    CONFIG_HTTP_SAMPLE_MULTI_CONNS
+#define TX_BUF_SIZE 512
+#define RX_BUF_SIZE 1024
+
+enum conn_state {
+	CONN_IDLE,
+	CONN_CONNECTING,
+	CONN_SENDING,
+	CONN_RECEIVING,
+};
+
+struct multi_conn {
+	struct http_multi_req *mreq;
+	enum conn_state state;
+	int sock;
+	int64_t start;
+	struct http_format_parser parser;
+	struct http_response rsp;
+	bool complete;
+	char tx_buf[TX_BUF_SIZE];
+	size_t tx_len;
+	size_t tx_sent;
+	uint8_t rx_buf[RX_BUF_SIZE];
+};
+
+static struct multi_conn conns[CONNS];
+
+static K_MUTEX_DEFINE(multi_lock);
+
+static void message_complete(struct http_format_parser *fp)
+{
+	CONTAINER_OF(fp, struct multi_conn, parser)->complete = true;
+}
+
+static int conn_open(struct multi_conn *conn)
+{
+	int err;
+	int sock;
+	bool tls = conn->mreq->sec_tag >= 0;
+	const char *host = conn->mreq->req.host;
+	struct zsock_addrinfo *result;
+	struct zsock_addrinfo hints = {
+		.ai_family = AF_INET,
+		.ai_socktype = SOCK_STREAM,
+	};
+
+	err = zsock_getaddrinfo(host, conn->mreq->port, &hints, &result);
+	if (err) {
+		LOG_WRN("Failed to resolve %s, err: %d, %s", host, err, zsock_gai_strerror(err));
+		return -EHOSTUNREACH;
+	}
+
+	sock = zsock_socket(AF_INET, SOCK_STREAM, tls ? IPPROTO_TLS_1_2 : IPPROTO_TCP);
+	if (sock < 0) {
+		zsock_freeaddrinfo(result);
+		return -errno;
+	}
+
+	if (tls) {
+		err = http_conn_tls_setup(sock, conn->mreq->sec_tag, host);
+		if (err) {
+			goto fail;
+		}
+	} else {
+		(void)zsock_fcntl(sock, F_SETFL, zsock_fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+	}
+
+	/* The TLS handshake runs inside connect() and blocks even on a non-blocking socket, so TLS
+	 * sockets only become non-blocking once they are connected.
+	 */
+	err = zsock_connect(sock, result->ai_addr, result->ai_addrlen);
+	if (err < 0 && errno != EINPROGRESS) {
+		err = -errno;
+		goto fail;
+	}
+
+	if (tls) {
+		(void)zsock_fcntl(sock, F_SETFL, zsock_fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+	}
+
+	zsock_freeaddrinfo(result);
+
+	conn->sock = sock;
+	conn->state = tls ? CONN_SENDING : CONN_CONNECTING;
+	return 0;
+
+fail:
+	zsock_freeaddrinfo(result);
+	(void)zsock_close(sock);
+	return err;
+}
+
+static int conn_start(struct multi_conn *conn, struct http_multi_req *mreq)
+{
+	int len;
+	int err;
+
+	conn->mreq = mreq;
+	conn->start = k_uptime_get();
+	mreq->result = -EINPROGRESS;
+
+	len = http_format_request(&mreq->req, false, conn->tx_buf, sizeof(conn->tx_buf));
+	if (len < 0) {
+		return -EMSGSIZE;
+	}
+
+	conn->tx_len = len;
+	conn->tx_sent = 0;
+	conn->complete = false;
+	memset(&conn->rsp, 0, sizeof(conn->rsp));
+	http_format_parser_init(&conn->parser, conn->rx_buf, sizeof(conn->rx_buf));
+	conn->parser.req = &mreq->req;
+	conn->parser.rsp = &conn->rsp;
+	conn->parser.user_data = mreq->user_data;
+	conn->parser.message_complete = message_complete;
+
+	err = conn_open(conn);
+	if (err) {
+		LOG_WRN("Failed to connect to %s, err: %d", mreq->req.host, err);
+	}
+
+	return err;
+}
+
+static void conn_finish(struct multi_conn *conn, int result)
+{
+	(void)zsock_close(conn->sock);
+
+	conn->state = CONN_IDLE;
+	conn->mreq->result = result;
+	conn->mreq->elapsed_ms = (uint32_t)(k_uptime_get() - conn->start);
+}
+
+static int conn_send(struct multi_conn *conn)
+{
+	ssize_t sent;
+
+	sent = zsock_send(conn->sock, conn->tx_buf + conn->tx_sent, conn->tx_len - conn->tx_sent,
+			  0);
+	if (sent < 0) {
+		return errno == EAGAIN ? 0 : -errno;
+	}
+
+	conn->tx_sent += sent;
+	if (conn->tx_sent == conn->tx_len) {
+		conn->state = CONN_RECEIVING;
+	}
+
+	return 0;
+}
+
+static int conn_receive(struct multi_conn *conn)
+{
+	int ret;
+	ssize_t received;
+
+	received = zsock_recv(conn->sock, conn->rx_buf, sizeof(conn->rx_buf), 0);
+	if (received < 0) {
+		return errno == EAGAIN ? 0 : -errno;
+	}
+
+	/* Zero bytes tell the parser that the server closed, which ends a body without a length. */
+	ret = http_format_parse(&conn->parser, received);
+
+	if (conn->complete) {
+		return 1;
+	} else if (ret < 0) {
+		LOG_ERR("Malformed response from %s: %s", conn->mreq->req.host,
+			http_errno_description(HTTP_PARSER_ERRNO(&conn->parser.parser)));
+		return ret;
+	} else if (received == 0) {
+		return -ECONNRESET;
+	}
+
+	return 0;
+}
+
+/* Advance a connection that poll() reported ready. Returns 1 once the response is complete. */
+static int conn_step(struct multi_conn *conn, short revents)
+{
+	int so_error = 0;
+	socklen_t optlen = sizeof(so_error);
+
+	if (revents & ZSOCK_POLLNVAL) {
+		return -EBADF;
+	}
+
+	switch (conn->state) {
+	case CONN_CONNECTING:
+		(void)zsock_getsockopt(conn->sock, SOL_SOCKET, SO_ERROR, &so_error, &optlen);
+		if (so_error) {
+			return -so_error;
+		}
+
+		conn->state = CONN_SENDING;
+		return conn_send(conn);
+	case CONN_SENDING:
+		return conn_send(conn);
+	default:
+		return conn_receive(conn);
+	}
+}
+
+static void conns_abort(int err)
+{
+	for (size_t i = 0; i < CONNS; i++) {
+		if (conns[i].state != CONN_IDLE) {
+			conn_finish(&conns[i], err);
+		}
+	}
+}
+
+int http_multi_run(struct http_multi_req *reqs, size_t count, int32_t timeout)
+{
+	int ret;
+	size_t n;
+	size_t next = 0;
+	size_t active = 0;
+	size_t c;
+	int responses = 0;
+	uint32_t slowest = 0;
+	uint32_t sum = 0;
+	int64_t start = k_uptime_get();
+	int64_t remaining;
+	struct zsock_pollfd fds[CONNS];
+	struct multi_conn *polled[CONNS];
+
+	k_mutex_lock(&multi_lock, K_FOREVER);
+
+	for (size_t i = 0; i < count; i++) {
+		reqs[i].result = -ETIMEDOUT;
+		reqs[i].elapsed_ms = 0;
+	}
+
+	while (next < count || active > 0) {
+		/* Start the next requests on the free connections. */
+		for (c = 0; c < CONNS && next < count; c++) {
+			while (conns[c].state == CONN_IDLE && next < count) {
+				ret = conn_start(&conns[c], &reqs[next]);
+				if (ret) {
+					reqs[next].result = ret;
+				} else {
+					active++;
+				}
+
+				next++;
+			}
+		}
+
+		if (active == 0) {
+			continue;
+		}
+
+		n = 0;
+		for (c = 0; c < CONNS; c++) {
+			if (conns[c].state == CONN_IDLE) {
+				continue;
+			}
+
+			fds[n].fd = conns[c].sock;
+			fds[n].events = conns[c].state == CONN_RECEIVING ? ZSOCK_POLLIN : ZSOCK_POLLOUT;
+			fds[n].revents = 0;
+			polled[n++] = &conns[c];
+		}
+
+		remaining = start + timeout - k_uptime_get();
+		if (remaining <= 0) {
+			conns_abort(-ETIMEDOUT);
+			break;
+		}
+
+		ret = zsock_poll(fds, n, (int)remaining);
+		if (ret < 0) {
+			ret = -errno;
+			LOG_ERR("poll failed, err: %d", ret);
+			conns_abort(ret);
+			break;
+		}
+
+		for (size_t i = 0; i < n; i++) {
+			if (fds[i].revents == 0) {
+				continue;
+			}
+
+			ret = conn_step(polled[i], fds[i].revents);
+			if (ret != 0) {
+				conn_finish(polled[i], ret > 0 ? 0 : ret);
+				active--;
+			}
+		}
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		if (reqs[i].result == 0) {
+			responses++;
+			slowest = MAX(slowest, reqs[i].elapsed_ms);
+			sum += reqs[i].elapsed_ms;
+		} else {
+			LOG_WRN("Request %zu to %s failed, err: %d", i, reqs[i].req.host,
+				reqs[i].result);
+		}
+	}
+
+	LOG_INF("%d of %zu requests on up to %d connections in %lld ms", responses, count, CONNS,
+		k_uptime_get() - start);
+	LOG_INF("Slowest request: %d ms, all requests one after the other: %d ms", slowest, sum);
+
+	k_mutex_unlock(&multi_lock);
+
+	return responses;
+}
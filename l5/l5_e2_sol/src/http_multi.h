@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef HTTP_MULTI_H_
+#define HTTP_MULTI_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/net/http/client.h>
+
+/** @brief One request of a batch run by http_multi_run(). */
+struct http_multi_req {
+	/* The request is sent to req.host, which does not have to be the same for all requests. */
+	struct http_request req;
+	const char *port;
+	/* Security tag of the CA certificate for HTTPS, or a negative value for plain HTTP. */
+	int sec_tag;
+	void *user_data;
+	/* Set by http_multi_run(): 0 once the response has been delivered, or a negative error. */
+	int result;
+	uint32_t elapsed_ms;
+};
+
+/**
+ * @brief Run a batch of independent requests in parallel, each on its own connection.
+ *
+ * Up to CONFIG_HTTP_SAMPLE_MULTI_CONNS connections are open at a time, and all of them are
+ * served by one zsock_poll() loop in the calling thread. Each response is delivered through the
+ * request's response callback with the request's user data, the last call with HTTP_DATA_FINAL.
+ * Responses of different requests can be delivered interleaved.
+ *
+ * Payload callbacks are not supported, and the payload must fit in the send buffer with the
+ * headers.
+ *
+ * @param timeout Time in milliseconds the whole batch may take.
+ *
+ * @return Number of requests that got a response.
+ */
+int http_multi_run(struct http_multi_req *reqs, size_t count, int32_t timeout);
+
+#endif /* HTTP_MULTI_H_ */
@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/http/client.h>
+#include <zephyr/net/http/parser.h>
+
+#include "http_conn.h"
+#include "http_format.h"
+#include "http_pipeline.h"
+
+LOG_MODULE_REGISTER(http_pipeline, LOG_LEVEL_INF);
+
+#define DEPTH	    CONFIG_HTTP_SAMPLE_PIPELINE_DEPTH
+#define TX_BUF_SIZE 512
+#define RX_BUF_SIZE 1024
+
+struct pipeline_slot {
+	struct http_request req;
+	struct http_response rsp;
+	void *user_data;
+	char payload[CONFIG_HTTP_SAMPLE_PIPELINE_PAYLOAD_SIZE];
+};
+
+static struct pipeline_slot slots[DEPTH];
+/* Requests in slots[0, queued) wait for a burst, responses have arrived for slots[0, answered). */
+static size_t queued;
+static size_t answered;
+
+static char tx_buf[TX_BUF_SIZE];
+static uint8_t rx_buf[RX_BUF_SIZE];
+
+static struct http_format_parser parser;
+static struct http_pipeline_stats stats;
+
+static K_MUTEX_DEFINE(pipeline_lock);
+
+static struct pipeline_slot *current(void)
+{
+	return answered < queued ? &slots[answered] : NULL;
+}
+
+/* Responses arrive in the order of the requests, each one answers the oldest unanswered one. */
+static int message_begin(struct http_format_parser *fp)
+{
+	struct pipeline_slot *slot = current();
+
+	if (!slot) {
+		/* More responses than requests, stop parsing. */
+		return -1;
+	}
+
+	fp->req = &slot->req;
+	fp->rsp = &slot->rsp;
+	fp->user_data = slot->user_data;
+
+	return 0;
+}
+
+static void message_complete(struct http_format_parser *fp)
+{
+	answered++;
+}
+
+static int send_all(int sock, const char *buf, size_t len)
+{
+	ssize_t sent;
+
+	while (len > 0) {
+		sent = zsock_send(sock, buf, len, 0);
+		if (sent < 0) {
+			return -errno;
+		}
+
+		buf += sent;
+		len -= sent;
+	}
+
+	return 0;
+}
+
+/* Write the unanswered requests with as few send calls as fit in tx_buf. */
+static int requests_send(int sock)
+{
+	int ret;
+	int len;
+	size_t used = 0;
+
+	for (size_t i = answered; i < queued; i++) {
+		len = http_format_request(&slots[i].req, true, tx_buf + used, sizeof(tx_buf) - used);
+		if (len < 0 && used > 0) {
+			ret = send_all(sock, tx_buf, used);
+			if (ret < 0) {
+				return ret;
+			}
+
+			used = 0;
+			len = http_format_request(&slots[i].req, true, tx_buf, sizeof(tx_buf));
+		}
+
+		if (len < 0) {
+			return len;
+		}
+
+		used += len;
+	}
+
+	return send_all(sock, tx_buf, used);
+}
+
+static int responses_recv(int sock, int32_t timeout)
+{
+	int ret;
+	ssize_t received;
+	struct zsock_pollfd fds = {
+		.fd = sock,
+		.events = ZSOCK_POLLIN,
+	};
+
+	while (answered < queued) {
+		ret = zsock_poll(&fds, 1, timeout);
+		if (ret == 0) {
+			return -ETIMEDOUT;
+		} else if (ret < 0) {
+			return -errno;
+		}
+
+		received = zsock_recv(sock, rx_buf, sizeof(rx_buf), 0);
+		if (received < 0) {
+			return -errno;
+		} else if (received == 0) {
+			return -ECONNRESET;
+		}
+
+		/* An error after the last response is a response nobody asked for. */
+		ret = http_format_parse(&parser, received);
+		if (ret < 0 && current()) {
+			LOG_ERR("Malformed response: %s",
+				http_errno_description(HTTP_PARSER_ERRNO(&parser.parser)));
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+int http_pipeline_add(const struct http_request *req, void *user_data)
+{
+	int ret;
+	struct pipeline_slot *slot;
+
+	if (req->payload_cb) {
+		/* Only payloads that are queued with the request can be written in a burst. */
+		return -ENOTSUP;
+	}
+
+	if (req->payload_len > CONFIG_HTTP_SAMPLE_PIPELINE_PAYLOAD_SIZE) {
+		return -EMSGSIZE;
+	}
+
+	k_mutex_lock(&pipeline_lock, K_FOREVER);
+
+	if (queued >= DEPTH) {
+		k_mutex_unlock(&pipeline_lock);
+		return -ENOBUFS;
+	}
+
+	slot = &slots[queued];
+	slot->req = *req;
+	slot->user_data = user_data;
+	if (req->payload_len > 0) {
+		memcpy(slot->payload, req->payload, req->payload_len);
+		slot->req.payload = slot->payload;
+	}
+
+	/* Reject requests that would not fit in the send buffer on their own. */
+	if (http_format_request(&slot->req, true, tx_buf, sizeof(tx_buf)) < 0) {
+		k_mutex_unlock(&pipeline_lock);
+		return -EMSGSIZE;
+	}
+
+	ret = ++queued;
+	k_mutex_unlock(&pipeline_lock);
+
+	return ret;
+}
+
+int http_pipeline_flush(int32_t timeout)
+{
+	int ret = 0;
+	int sock;
+	bool reused;
+	size_t count;
+	int64_t start;
+	uint32_t elapsed;
+
+	k_mutex_lock(&pipeline_lock, K_FOREVER);
+
+	if (queued == 0) {
+		k_mutex_unlock(&pipeline_lock);
+		return 0;
+	}
+
+	start = k_uptime_get();
+	answered = 0;
+
+	for (int attempt = 0; attempt < 2 && answered < queued; attempt++) {
+		sock = http_conn_acquire(&reused);
+		if (sock < 0) {
+			ret = sock;
+			break;
+		}
+
+		if (attempt > 0) {
+			stats.resent += queued - answered;
+		}
+
+		http_format_parser_init(&parser, rx_buf, sizeof(rx_buf));
+		parser.message_begin = message_begin;
+		parser.message_complete = message_complete;
+
+		ret = requests_send(sock);
+		if (ret == 0) {
+			ret = responses_recv(sock, timeout);
+		}
+
+		http_conn_release(ret == 0 && http_should_keep_alive(&parser.parser));
+
+		if (ret < 0) {
+			LOG_WRN("Connection lost after %zu of %zu responses, err: %d", answered,
+				queued, ret);
+		}
+	}
+
+	elapsed = (uint32_t)(k_uptime_get() - start);
+	count = answered;
+
+	stats.bursts++;
+	stats.requests += queued;
+	stats.responses += answered;
+	stats.dropped += queued - answered;
+	stats.max_depth = MAX(stats.max_depth, queued);
+	stats.burst_ms_total += elapsed;
+
+	LOG_INF("Burst of %zu requests took %d ms, %zu ms per request", queued, elapsed,
+		elapsed / queued);
+
+	queued = 0;
+	answered = 0;
+	k_mutex_unlock(&pipeline_lock);
+
+	return (ret < 0 && count == 0) ? ret : count;
+}
+
+void http_pipeline_stats_get(struct http_pipeline_stats *out)
+{
+	k_mutex_lock(&pipeline_lock, K_FOREVER);
+	*out = stats;
+	k_mutex_unlock(&pipeline_lock);
+}
+
+void http_pipeline_stats_log(void)
+{
+	struct http_pipeline_stats s;
+
+	http_pipeline_stats_get(&s);
+
+	LOG_INF("%d bursts, %d requests, max depth %d", s.bursts, s.requests, s.max_depth);
+	LOG_INF("Responses: %d, resent: %d, dropped: %d", s.responses, s.resent, s.dropped);
+	LOG_INF("Average burst: %d ms", s.bursts ? s.burst_ms_total / s.bursts : 0);
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef HTTP_PIPELINE_H_
+#define HTTP_PIPELINE_H_
+
+#include <stdint.h>
+#include <zephyr/net/http/client.h>
+
+/** @brief Counters kept by the request pipeline. */
+struct http_pipeline_stats {
+	uint32_t bursts;
+	uint32_t requests;
+	uint32_t responses;
+	/* Requests sent again on a new connection because the old one closed before answering. */
+	uint32_t resent;
+	uint32_t dropped;
+	uint16_t max_depth;
+	uint32_t burst_ms_total;
+};
+
+/**
+ * @brief Queue a request for the next burst.
+ *
+ * The request and its payload are copied. The URL, host and header strings are not and must stay
+ * valid until the response has been delivered.
+ *
+ * @return Number of requests queued, including this one.
+ * @retval -ENOBUFS if CONFIG_HTTP_SAMPLE_PIPELINE_DEPTH requests are already queued.
+ * @retval -EMSGSIZE if the payload is larger than CONFIG_HTTP_SAMPLE_PIPELINE_PAYLOAD_SIZE.
+ * @retval -ENOTSUP if the request has a payload callback.
+ */
+int http_pipeline_add(const struct http_request *req, void *user_data);
+
+/**
+ * @brief Send all queued requests back-to-back on one connection and wait for the responses.
+ *
+ * Responses are matched to requests in the order they were queued and delivered through each
+ * request's response callback, the last call with HTTP_DATA_FINAL. If the connection closes
+ * before every response has arrived, the unanswered requests are sent once more on a new
+ * connection.
+ *
+ * @param timeout Time in milliseconds to wait for each part of a response.
+ *
+ * @return Number of responses delivered, or a negative error code.
+ */
+int http_pipeline_flush(int32_t timeout);
+
+void http_pipeline_stats_get(struct http_pipeline_stats *stats);
+
+void http_pipeline_stats_log(void);
+
+#endif /* HTTP_PIPELINE_H_ */
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/http/client.h>
+
+#include "http_upload.h"
+
+LOG_MODULE_REGISTER(http_upload, LOG_LEVEL_INF);
+
+#define CHUNK_SIZE CONFIG_HTTP_SAMPLE_UPLOAD_CHUNK_SIZE
+/* Room for the chunk size in hex and its CRLF in front of the data. */
+#define CHUNK_HEADER_MAX 10
+
+static http_upload_producer_t producer;
+static void *producer_ctx;
+static bool started;
+
+/* Chunk header, data and trailing CRLF, so that each chunk goes out with one send. */
+static uint8_t chunk_buf[CHUNK_HEADER_MAX + CHUNK_SIZE + 2];
+
+static const char *chunked_headers[] = {"Transfer-Encoding: chunked\r\n", NULL};
+
+static int send_all(int sock, const uint8_t *buf, size_t len)
+{
+	ssize_t sent;
+
+	while (len > 0) {
+		sent = zsock_send(sock, buf, len, 0);
+		if (sent < 0) {
+			return -errno;
+		}
+
+		buf += sent;
+		len -= sent;
+	}
+
+	return 0;
+}
+
+static int chunk_send(int sock, size_t len)
+{
+	char header[CHUNK_HEADER_MAX + 1];
+	int header_len;
+	uint8_t *start;
+
+	/* Place the header right in front of the data, the last chunk is just "0\r\n\r\n". */
+	header_len = snprintk(header, sizeof(header), "%zx\r\n", len);
+	start = chunk_buf + CHUNK_HEADER_MAX - header_len;
+	memcpy(start, header, header_len);
+	memcpy(chunk_buf + CHUNK_HEADER_MAX + len, "\r\n", 2);
+
+	return send_all(sock, start, header_len + len + 2);
+}
+
+static int upload_payload_cb(int sock, struct http_request *req, void *user_data)
+{
+	int ret;
+	size_t len;
+	size_t total = 0;
+	uint32_t chunks = 0;
+	int64_t start = k_uptime_get();
+
+	/* A retry on a new connection cannot send the part of the body already produced. */
+	if (started) {
+		return -ECANCELED;
+	}
+
+	started = true;
+
+	do {
+		ret = producer(chunk_buf + CHUNK_HEADER_MAX, CHUNK_SIZE, producer_ctx);
+		if (ret < 0) {
+			LOG_ERR("Producer failed after %zu bytes, err: %d", total, ret);
+			return ret;
+		}
+
+		len = MIN(ret, CHUNK_SIZE);
+		ret = chunk_send(sock, len);
+		if (ret < 0) {
+			LOG_ERR("Failed to send chunk, err: %d", ret);
+			return ret;
+		}
+
+		total += len;
+		chunks++;
+	} while (len > 0);
+
+	LOG_INF("Uploaded %zu bytes in %d chunks in %lld ms", total, chunks - 1,
+		k_uptime_get() - start);
+
+	return total;
+}
+
+void http_upload_prepare(struct http_request *req, http_upload_producer_t producer_cb, void *ctx)
+{
+	producer = producer_cb;
+	producer_ctx = ctx;
+	started = false;
+
+	req->optional_headers = chunked_headers;
+	req->payload_cb = upload_payload_cb;
+}
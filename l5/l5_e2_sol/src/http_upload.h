@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef HTTP_UPLOAD_H_
+#define HTTP_UPLOAD_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/net/http/client.h>
+
+/**
+ * @brief Producer of a request body.
+ *
+ * Called each time the previous chunk has been handed to the socket.
+ *
+ * @param buf Buffer to write the next part of the body to.
+ * @param size Size of the buffer, CONFIG_HTTP_SAMPLE_UPLOAD_CHUNK_SIZE.
+ * @param ctx Context passed to http_upload_prepare().
+ *
+ * @return Number of bytes written, 0 at the end of the body, or a negative error code to abort
+ *	   the request.
+ */
+typedef int (*http_upload_producer_t)(uint8_t *buf, size_t size, void *ctx);
+
+/**
+ * @brief Send the body of a request with chunked transfer encoding, pulled from a producer.
+ *
+ * Sets the optional headers and the payload callback of the request. Its payload and payload_len
+ * must not be set. The body can be of any length and is sent with one chunk buffer. Only one
+ * request prepared this way can be in flight at a time, and it cannot be pipelined. Prepare it
+ * right before sending it, on the thread that sends it. A request queued after being prepared,
+ * e.g. with http_async_submit(), would share its state with the next one.
+ */
+void http_upload_prepare(struct http_request *req, http_upload_producer_t producer, void *ctx);
+
+#endif /* HTTP_UPLOAD_H_ */
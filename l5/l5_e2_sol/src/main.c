@@ -18,11 +18,24 @@
 #include <zephyr/net/wifi_mgmt.h>
 #include <zephyr/net/wifi_credentials.h>
 #include <zephyr/net/socket.h>
+#include <zephyr/net/conn_mgr_monitor.h>
 #include <zephyr/net/http/client.h>
 
 /* STEP 1.5 - Include the header file for the TLS credentials library */
 #include <zephyr/net/tls_credentials.h>
 
+#include "handshake_stats.h"
+#include "http_async.h"
+#include "http_bench.h"
+#include "http_body.h"
+#include "http_cache.h"
+#include "http_conn.h"
+#include "http_download.h"
+#include "http_inflate.h"
+#include "http_multi.h"
+#include "http_pipeline.h"
+#include "http_upload.h"
+
 LOG_MODULE_REGISTER(Lesson5_Exercise2, LOG_LEVEL_INF);
 
 #define EVENT_MASK (NET_EVENT_L4_CONNECTED | NET_EVENT_L4_DISCONNECTED)
@@ -40,6 +53,19 @@ static int counter = 0;
 
 static int sock;
 static struct sockaddr_storage server;
+/* Set while the socket layer should hold a session for the server, so the next connect offers
+ * it. Only a guess: the server can still decline it and the stats then show a full handshake.
+ */
+static bool tls_session_cached;
+
+static struct http_body response_body;
+static struct http_body client_id_body;
+/* Body of GET responses, through the decoder and the cache when they are enabled. */
+static struct http_body get_body;
+/* Optional headers of GET requests, kept until a queued request has been sent. */
+static struct http_conn_headers get_headers;
+/* Cache state of GET requests, all for the same URL and sink. */
+static struct http_cache_request get_cache;
 
 static struct net_mgmt_event_callback mgmt_cb;
 static bool connected;
@@ -133,71 +159,237 @@ static int server_connect(void)
 	}
 
 	/* STEP 5.1 - Configure the socket with the security tag for the certificate */
-	sec_tag_t sec_tag_opt[] = {
-		HTTP_TLS_SEC_TAG,
-	};
-	err = zsock_setsockopt(sock, SOL_TLS, TLS_SEC_TAG_LIST, sec_tag_opt, sizeof(sec_tag_opt));
-	if (err < 0) {
-		LOG_ERR("Failed to set TLS security TAG list, err: %d", errno);
-		(void)zsock_close(sock);
-		return -errno;
-	}
 	/* STEP 5.2 - Configure the socket with the hostname of the HTTP server */
-	err = zsock_setsockopt(sock, SOL_TLS, TLS_HOSTNAME, CONFIG_HTTP_SAMPLE_HOSTNAME, sizeof(CONFIG_HTTP_SAMPLE_HOSTNAME));
+	err = http_conn_tls_setup(sock, HTTP_TLS_SEC_TAG, CONFIG_HTTP_SAMPLE_HOSTNAME);
 	if (err < 0) {
-		LOG_ERR("Failed to set TLS_HOSTNAME option. Err: %d", errno);
+		LOG_ERR("Failed to set up TLS on the socket, err: %d", err);
 		(void)zsock_close(sock);
-		return -errno;
+		return err;
+	}
+
+	if (IS_ENABLED(CONFIG_HTTP_SAMPLE_HANDSHAKE_STATS)) {
+		handshake_stats_start();
 	}
 
 	err = zsock_connect(sock, (struct sockaddr *)&server, sizeof(struct sockaddr_in));
 	if (err < 0) {
 		LOG_ERR("Connecting to server failed, err: %d, %s", errno, strerror(errno));
-		return -errno;
+		err = -errno;
+		(void)zsock_close(sock);
+		/* A failed handshake drops the cached session of the server. */
+		tls_session_cached = false;
+		return err;
+	}
+
+	if (IS_ENABLED(CONFIG_HTTP_SAMPLE_HANDSHAKE_STATS)) {
+		handshake_stats_done(tls_session_cached);
+	}
+
+	/* The TLS socket stores the session of a successful handshake when caching is on. */
+	if (IS_ENABLED(CONFIG_HTTP_SAMPLE_TLS_SESSION_CACHE)) {
+		tls_session_cached = true;
 	}
 
 	LOG_INF("Connected to server");
-	return 0;
+	return sock;
 }
 
-static int response_cb(struct http_response *rsp, enum http_final_call final_data, void *user_data)
+static int client_id_begin(const struct http_response *rsp, void *ctx)
 {
 	LOG_INF("Response status: %s", rsp->http_status);
+	return 0;
+}
 
-	if (rsp->body_frag_len > 0) {
-		char body_buf[rsp->body_frag_len];
-		strncpy(body_buf, rsp->body_frag_start, rsp->body_frag_len);
-		body_buf[rsp->body_frag_len] = '\0';
-		LOG_INF("Received: %s", body_buf);
+static int client_id_write(size_t offset, const uint8_t *data, size_t len, void *ctx)
+{
+	/* Anything after the ID, such as a trailing newline, is ignored. */
+	if (offset < CLIENT_ID_SIZE) {
+		memcpy(&client_id_buf[1 + offset], data, MIN(len, CLIENT_ID_SIZE - offset));
 	}
 
-	LOG_INF("Closing socket: %d", sock);
-	zsock_close(sock);
 	return 0;
 }
 
-static int client_id_cb(struct http_response *rsp, enum http_final_call final_data,
-			 void *user_data)
+static void client_id_end(int status, void *ctx)
 {
-	LOG_INF("Response status: %s", rsp->http_status);
+	if (status < 0) {
+		LOG_ERR("Failed to receive client ID, err: %d", status);
+		return;
+	}
 
-	char client_id_buf_tmp[CLIENT_ID_SIZE + 1];
-	strncpy(client_id_buf_tmp, rsp->body_frag_start, CLIENT_ID_SIZE);
-	client_id_buf_tmp[CLIENT_ID_SIZE] = '\0';
 	client_id_buf[0] = '/';
-	strcat(client_id_buf, client_id_buf_tmp);
-
 	LOG_INF("Successfully acquired client ID: %s", client_id_buf);
-	LOG_INF("Closing socket: %d", sock);
-	zsock_close(sock);
+}
+
+static const struct http_body_sink client_id_sink = {
+	.begin = client_id_begin,
+	.write = client_id_write,
+	.end = client_id_end,
+};
+
+#if defined(CONFIG_HTTP_SAMPLE_ASYNC)
+#define HTTP_WORK_Q http_async_work_q()
+#elif defined(CONFIG_HTTP_SAMPLE_PIPELINE)
+/* A flush waits for every response of the burst, which must not hold up the system work queue. */
+static struct k_work_q pipeline_work_q;
+static K_THREAD_STACK_DEFINE(pipeline_work_q_stack, CONFIG_HTTP_SAMPLE_PIPELINE_STACK_SIZE);
+#define HTTP_WORK_Q (&pipeline_work_q)
+#endif
+
+#if defined(CONFIG_HTTP_SAMPLE_PIPELINE)
+static void pipeline_work_fn(struct k_work *work)
+{
+	(void)http_pipeline_flush(5000);
+}
+
+static K_WORK_DELAYABLE_DEFINE(pipeline_work, pipeline_work_fn);
+
+/* Queue a request and send the burst when the pipeline is full or the gather time has passed. */
+static int client_http_queue(const struct http_request *req, struct http_body *body)
+{
+	int ret = http_pipeline_add(req, body);
+
+	if (ret < 0) {
+		LOG_ERR("Failed to queue HTTP request, err: %d", ret);
+		return ret;
+	}
+
+	if (ret >= CONFIG_HTTP_SAMPLE_PIPELINE_DEPTH) {
+		(void)k_work_reschedule_for_queue(HTTP_WORK_Q, &pipeline_work, K_NO_WAIT);
+	} else {
+		(void)k_work_schedule_for_queue(HTTP_WORK_Q, &pipeline_work,
+						K_MSEC(CONFIG_HTTP_SAMPLE_PIPELINE_GATHER_MS));
+	}
+
 	return 0;
 }
+#endif
+
+#if defined(CONFIG_HTTP_SAMPLE_ASYNC)
+static void client_http_done(int result, void *user_data)
+{
+	if (result < 0) {
+		LOG_ERR("HTTP request failed, err: %d", result);
+		http_body_abort(user_data, result);
+	}
+}
+#endif
+
+/* Send a request now, or hand it to the pipeline or the HTTP work queue when enabled. */
+static int client_http_send(struct http_request *req, struct http_body *body)
+{
+#if defined(CONFIG_HTTP_SAMPLE_PIPELINE)
+	return client_http_queue(req, body);
+#elif defined(CONFIG_HTTP_SAMPLE_ASYNC)
+	return http_async_submit(req, 5000, client_http_done, body);
+#else
+	int err = http_conn_request(req, 5000, body);
+
+	if (err < 0) {
+		http_body_abort(body, err);
+	}
+
+	return err;
+#endif
+}
+
+#if defined(CONFIG_HTTP_SAMPLE_UPLOAD)
+static int batch_line;
+/* http_upload holds the state of one request, so uploads are prepared and sent one at a time. */
+static K_MUTEX_DEFINE(upload_lock);
+
+/* Produce a batch of CSV lines of counter, line number and uptime, as many as fit per chunk. */
+static int batch_produce(uint8_t *buf, size_t size, void *ctx)
+{
+	char line[36];
+	size_t len = 0;
+	int n;
+
+	while (batch_line < CONFIG_HTTP_SAMPLE_UPLOAD_LINES) {
+		n = snprintf(line, sizeof(line), "%d,%d,%u\n", counter, batch_line,
+			     k_uptime_get_32());
+		if (len + n > size) {
+			break;
+		}
+
+		memcpy(buf + len, line, n);
+		len += n;
+		batch_line++;
+	}
+
+	return len;
+}
+
+static int client_http_upload_send(void)
+{
+	int err;
+
+	struct http_request req;
+	memset(&req, 0, sizeof(req));
+
+	req.method = HTTP_PUT;
+	req.url = client_id_buf;
+	req.host = CONFIG_HTTP_SAMPLE_HOSTNAME;
+	req.protocol = "HTTP/1.1";
+	req.content_type_value = "text/csv";
+	req.response = http_body_response_cb;
+	req.recv_buf = recv_buf;
+	req.recv_buf_len = sizeof(recv_buf);
+
+	k_mutex_lock(&upload_lock, K_FOREVER);
+
+	batch_line = 0;
+	http_upload_prepare(&req, batch_produce, NULL);
+
+	LOG_INF("HTTP PUT request: %d lines, chunked", CONFIG_HTTP_SAMPLE_UPLOAD_LINES);
+
+	err = http_conn_request(&req, 5000, &response_body);
+	if (err < 0) {
+		http_body_abort(&response_body, err);
+	}
+
+	k_mutex_unlock(&upload_lock);
+
+	if (err < 0) {
+		LOG_ERR("Failed to send chunked HTTP PUT request, err: %d", err);
+	}
+
+	return err;
+}
+
+#if defined(CONFIG_HTTP_SAMPLE_ASYNC)
+static void upload_work_fn(struct k_work *work)
+{
+	(void)client_http_upload_send();
+}
+
+static K_WORK_DEFINE(upload_work, upload_work_fn);
+#endif
+
+static int client_http_upload(void)
+{
+	/* The body is produced while it is sent, so it cannot wait in the pipeline. With the HTTP
+	 * work queue the upload is prepared there too, right before it is sent, so an upload that
+	 * is still queued does not share the producer state with the next one.
+	 */
+#if defined(CONFIG_HTTP_SAMPLE_ASYNC)
+	int ret = k_work_submit_to_queue(http_async_work_q(), &upload_work);
+
+	return ret < 0 ? ret : 0;
+#else
+	return client_http_upload_send();
+#endif
+}
+#endif
 
 static int client_http_put(void)
 {
 	int err = 0;
 	int bytes_written;
-	const char *headers[] = {"Connection: close\r\n", NULL};
+
+#if defined(CONFIG_HTTP_SAMPLE_UPLOAD)
+	return client_http_upload();
+#endif
 
 	struct http_request req;
 	memset(&req, 0, sizeof(req));
@@ -209,19 +401,18 @@ static int client_http_put(void)
 		return bytes_written;
 	}
 
-	req.header_fields = headers;
 	req.method = HTTP_PUT;
 	req.url = client_id_buf;
 	req.host = CONFIG_HTTP_SAMPLE_HOSTNAME;
 	req.protocol = "HTTP/1.1";
 	req.payload = buffer;
 	req.payload_len = bytes_written;
-	req.response = response_cb;
+	req.response = http_body_response_cb;
 	req.recv_buf = recv_buf;
 	req.recv_buf_len = sizeof(recv_buf);
 
 	LOG_INF("HTTP PUT request: %s", buffer);
-	err = http_client_req(sock, &req, 5000, NULL);
+	err = client_http_send(&req, &response_body);
 	if (err < 0) {
 		LOG_ERR("Failed to send HTTP PUT request %s, err: %d", buffer, err);
 	}
@@ -232,22 +423,34 @@ static int client_http_put(void)
 static int client_http_get(void)
 {
 	int err = 0;
-	const char *headers[] = {"Connection: close\r\n", NULL};
 
 	struct http_request req;
 	memset(&req, 0, sizeof(req));
 
-	req.header_fields = headers;
 	req.method = HTTP_GET;
 	req.url = client_id_buf;
 	req.host = CONFIG_HTTP_SAMPLE_HOSTNAME;
 	req.protocol = "HTTP/1.1";
-	req.response = response_cb;
+	req.response = http_body_response_cb;
 	req.recv_buf = recv_buf;
 	req.recv_buf_len = sizeof(recv_buf);
 
+	http_conn_headers_init(&get_headers, &req);
+
+	/* Decoded bodies are cached, so a 304 is served without decoding again. */
+	if (IS_ENABLED(CONFIG_HTTP_SAMPLE_CACHE)) {
+		http_cache_request_prepare(&get_cache, &req, &get_headers, &http_body_log_sink);
+	}
+
+	if (IS_ENABLED(CONFIG_HTTP_SAMPLE_INFLATE)) {
+		http_inflate_request_prepare(&req, &get_headers,
+					     IS_ENABLED(CONFIG_HTTP_SAMPLE_CACHE)
+						     ? &get_cache.sink
+						     : &http_body_log_sink);
+	}
+
 	LOG_INF("HTTP GET request");
-	err = http_client_req(sock, &req, 5000, NULL);
+	err = client_http_send(&req, &get_body);
 	if (err < 0) {
 		LOG_ERR("Failed to send HTTP GET request, err: %d", err);
 	}
@@ -255,6 +458,50 @@ static int client_http_get(void)
 	return err;
 }
 
+#if defined(CONFIG_HTTP_SAMPLE_MULTI)
+static struct http_multi_req multi_reqs[CONFIG_HTTP_SAMPLE_MULTI_COUNT];
+
+static int multi_response_cb(struct http_response *rsp, enum http_final_call final_data,
+			     void *user_data)
+{
+	if (final_data == HTTP_DATA_FINAL) {
+		LOG_INF("Parallel request %d: %s, %zu body bytes", (int)(intptr_t)user_data,
+			rsp->http_status, rsp->processed);
+	}
+
+	return 0;
+}
+
+static int client_http_multi(void)
+{
+	int responses;
+
+	memset(multi_reqs, 0, sizeof(multi_reqs));
+
+	for (size_t i = 0; i < ARRAY_SIZE(multi_reqs); i++) {
+		multi_reqs[i].req.method = HTTP_GET;
+		multi_reqs[i].req.url = client_id_buf;
+		multi_reqs[i].req.host = CONFIG_HTTP_SAMPLE_HOSTNAME;
+		multi_reqs[i].req.protocol = "HTTP/1.1";
+		multi_reqs[i].req.response = multi_response_cb;
+		multi_reqs[i].port = CONFIG_HTTP_SAMPLE_PORT;
+		multi_reqs[i].sec_tag = HTTP_TLS_SEC_TAG;
+		multi_reqs[i].user_data = (void *)(intptr_t)i;
+	}
+
+	LOG_INF("%d HTTP GET requests on up to %d connections", CONFIG_HTTP_SAMPLE_MULTI_COUNT,
+		CONFIG_HTTP_SAMPLE_MULTI_CONNS);
+	responses = http_multi_run(multi_reqs, ARRAY_SIZE(multi_reqs), 10000);
+	if (responses < (int)ARRAY_SIZE(multi_reqs)) {
+		LOG_ERR("Only %d of %d parallel requests got a response", responses,
+			CONFIG_HTTP_SAMPLE_MULTI_COUNT);
+		return -EIO;
+	}
+
+	return 0;
+}
+#endif
+
 static int client_get_new_id(void)
 {
 	int err = 0;
@@ -262,20 +509,19 @@ static int client_get_new_id(void)
 	struct http_request req;
 	memset(&req, 0, sizeof(req));
 
-	const char *headers[] = {"Connection: close\r\n", NULL};
-	req.header_fields = headers;
 	req.method = HTTP_POST;
 	req.url = "/new";
 	req.host = CONFIG_HTTP_SAMPLE_HOSTNAME;
 	req.protocol = "HTTP/1.1";
-	req.response = client_id_cb;
+	req.response = http_body_response_cb;
 	req.recv_buf = recv_buf;
 	req.recv_buf_len = sizeof(recv_buf);
 
 	LOG_INF("HTTP POST request");
-	err = http_client_req(sock, &req, 5000, NULL);
+	err = http_conn_request(&req, 5000, &client_id_body);
 	if (err < 0) {
 		LOG_ERR("Failed to send HTTP POST request, err: %d", err);
+		http_body_abort(&client_id_body, err);
 	}
 	return err;
 }
@@ -283,13 +529,26 @@ static int client_get_new_id(void)
 static void button_handler(uint32_t button_state, uint32_t has_changed)
 {
 	if (has_changed & DK_BTN1_MSK && button_state & DK_BTN1_MSK) {
-		if (server_connect() >= 0) {
-			client_http_put();
+		if (client_http_put() >= 0) {
 			counter++;
 		}
 	} else if (has_changed & DK_BTN2_MSK && button_state & DK_BTN2_MSK) {
-		if (server_connect() >= 0) {
-			client_http_get();
+		client_http_get();
+		http_conn_stats_log();
+		if (IS_ENABLED(CONFIG_HTTP_SAMPLE_HANDSHAKE_STATS)) {
+			handshake_stats_log();
+		}
+		if (IS_ENABLED(CONFIG_HTTP_SAMPLE_PIPELINE)) {
+			http_pipeline_stats_log();
+		}
+		if (IS_ENABLED(CONFIG_HTTP_SAMPLE_ASYNC)) {
+			http_async_stats_log();
+		}
+		if (IS_ENABLED(CONFIG_HTTP_SAMPLE_CACHE)) {
+			http_cache_stats_log();
+		}
+		if (IS_ENABLED(CONFIG_HTTP_SAMPLE_INFLATE)) {
+			http_inflate_stats_log();
 		}
 	}
 }
@@ -307,12 +566,12 @@ int main(void)
 	net_mgmt_init_event_callback(&mgmt_cb, net_mgmt_event_handler, EVENT_MASK);
 	net_mgmt_add_event_callback(&mgmt_cb);
 
+	/* With a static address, e.g. on native_sim, L4 is up before the callback is added. */
+	conn_mgr_mon_resend_status();
+
 	LOG_INF("Waiting to connect to Wi-Fi");
 	k_sem_take(&run_app, K_FOREVER);
 
-	if (dk_buttons_init(button_handler) != 0) {
-		LOG_ERR("Failed to initialize the buttons library");
-	}
 	if (server_resolve() != 0) {
 		LOG_ERR("Failed to resolve server name");
 		return 0;
@@ -322,21 +581,64 @@ int main(void)
 		LOG_ERR("Setup credentials failed");
 	}
 
-	LOG_INF("Connecting to %s:%s", CONFIG_HTTP_SAMPLE_HOSTNAME, CONFIG_HTTP_SAMPLE_PORT);
-	if (server_connect() != 0) {
-		LOG_ERR("Failed to connect to server");
+	http_body_init(&response_body, &http_body_log_sink);
+	http_body_init(&client_id_body, &client_id_sink);
+	if (IS_ENABLED(CONFIG_HTTP_SAMPLE_INFLATE)) {
+		http_body_init(&get_body, &http_inflate_sink);
+	} else if (IS_ENABLED(CONFIG_HTTP_SAMPLE_CACHE)) {
+		http_body_init(&get_body, &get_cache.sink);
+	} else {
+		http_body_init(&get_body, &http_body_log_sink);
+	}
+
+	if (http_conn_init(server_connect) != 0) {
+		LOG_ERR("Failed to initialize the connection manager");
 		return 0;
 	}
 
+	if (IS_ENABLED(CONFIG_HTTP_SAMPLE_BENCH)) {
+		(void)http_bench_run();
+		return 0;
+	}
+
+	if (IS_ENABLED(CONFIG_HTTP_SAMPLE_ASYNC) && http_async_init() != 0) {
+		LOG_ERR("Failed to start the HTTP work queue");
+		return 0;
+	}
+
+#if defined(CONFIG_HTTP_SAMPLE_PIPELINE) && !defined(CONFIG_HTTP_SAMPLE_ASYNC)
+	struct k_work_queue_config pipeline_cfg = {
+		.name = "http_pipeline",
+	};
+
+	k_work_queue_init(&pipeline_work_q);
+	k_work_queue_start(&pipeline_work_q, pipeline_work_q_stack,
+			   K_THREAD_STACK_SIZEOF(pipeline_work_q_stack),
+			   K_LOWEST_APPLICATION_THREAD_PRIO, &pipeline_cfg);
+#endif
+
+	/* Button presses submit to the HTTP work queue, which is started by now. */
+	if (dk_buttons_init(button_handler) != 0) {
+		LOG_ERR("Failed to initialize the buttons library");
+	}
+
+	LOG_INF("Connecting to %s:%s", CONFIG_HTTP_SAMPLE_HOSTNAME, CONFIG_HTTP_SAMPLE_PORT);
 	if (client_get_new_id() < 0) {
 		LOG_ERR("Failed to get client ID");
 		return 0;
 	}
 
-	if (server_connect() >= 0) {
-		client_http_put();
+	if (client_http_put() >= 0) {
 		counter++;
 	}
 
+	if (IS_ENABLED(CONFIG_HTTP_SAMPLE_DOWNLOAD)) {
+		(void)http_download_run();
+	}
+
+#if defined(CONFIG_HTTP_SAMPLE_MULTI)
+	(void)client_http_multi();
+#endif
+
 	return 0;
 }
@@ -121,18 +121,37 @@ static int server_connect(void)
 	return 0;
 }
 
+/* The response callbacks close the socket once a response is complete, the request functions
+ * close it when a request fails before that.
+ */
+static void socket_close(void)
+{
+	if (sock < 0) {
+		return;
+	}
+
+	zsock_close(sock);
+	sock = -1;
+}
+
 static int response_cb(struct http_response *rsp, enum http_final_call final_data, void *user_data)
 {
 	LOG_INF("Response status: %s", rsp->http_status);
 
 	if (rsp->body_frag_len > 0) {
-		char body_buf[rsp->body_frag_len];
-		strncpy(body_buf, rsp->body_frag_start, rsp->body_frag_len);
+		/* A fragment is at most the size of recv_buf, plus one byte for the terminator */
+		static char body_buf[RECV_BUF_SIZE + 1];
+
+		memcpy(body_buf, rsp->body_frag_start, rsp->body_frag_len);
 		body_buf[rsp->body_frag_len] = '\0';
 		LOG_INF("Received: %s", body_buf);
 	}
 
-	zsock_close(sock);
+	/* Close only after the last fragment, the client still reads from the socket until then */
+	if (final_data == HTTP_DATA_FINAL) {
+		socket_close();
+	}
+
 	return 0;
 }
 
@@ -141,15 +160,20 @@ static int client_id_cb(struct http_response *rsp, enum http_final_call final_da
 {
 	LOG_INF("Response status: %s", rsp->http_status);
 
-	char client_id_buf_tmp[CLIENT_ID_SIZE + 1];
-	strncpy(client_id_buf_tmp, rsp->body_frag_start, CLIENT_ID_SIZE);
-	client_id_buf_tmp[CLIENT_ID_SIZE] = '\0';
-	client_id_buf[0] = '/';
-	strcat(client_id_buf, client_id_buf_tmp);
+	/* The ID can arrive in several fragments, append each one after the leading '/' */
+	if (rsp->body_frag_len > 0) {
+		size_t used = strlen(client_id_buf);
+		size_t len = MIN(rsp->body_frag_len, sizeof(client_id_buf) - 1 - used);
+
+		memcpy(&client_id_buf[used], rsp->body_frag_start, len);
+		client_id_buf[used + len] = '\0';
+	}
 
-	LOG_INF("Successfully acquired client ID: %s", client_id_buf);
+	if (final_data == HTTP_DATA_FINAL) {
+		LOG_INF("Successfully acquired client ID: %s", client_id_buf);
+		socket_close();
+	}
 
-	zsock_close(sock);
 	return 0;
 }
 
@@ -184,6 +208,7 @@ static int client_http_put(void)
 	err = http_client_req(sock, &req, 5000, NULL);
 	if (err < 0) {
 		LOG_ERR("Failed to send HTTP PUT request %s, err: %d", buffer, err);
+		socket_close();
 	}
 
 	return err;
@@ -210,6 +235,7 @@ static int client_http_get(void)
 	err = http_client_req(sock, &req, 5000, NULL);
 	if (err < 0) {
 		LOG_ERR("Failed to send HTTP GET request, err: %d", err);
+		socket_close();
 	}
 
 	return err;
@@ -232,10 +258,14 @@ static int client_get_new_id(void)
 	req.recv_buf = recv_buf;
 	req.recv_buf_len = sizeof(recv_buf);
 
+	/* client_id_cb() appends the ID to this */
+	strcpy(client_id_buf, "/");
+
 	LOG_INF("HTTP POST request");
 	err = http_client_req(sock, &req, 5000, NULL);
 	if (err < 0) {
 		LOG_ERR("Failed to send HTTP POST request, err: %d", err);
+		socket_close();
 	}
 	return err;
 }
@@ -367,6 +397,6 @@ int main(void)
 		return 0;
 	}
 
-	zsock_close(sock);
+	socket_close();
 	return 0;
 }
\ No newline at end of file